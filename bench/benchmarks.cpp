@@ -0,0 +1,303 @@
+#include <streambuf>
+#include <iostream>
+#include <memory>
+#include <array>
+
+#include <chasm/ds/disassembly_interface.hpp>
+#include <chasm/ds/listing_renderer.hpp>
+#include <chasm/ds/disassembler.hpp>
+#include <chasm/symbol_sanitizer.hpp>
+#include <chasm/output_format.hpp>
+#include <chasm/generator.hpp>
+#include <chasm/options.hpp>
+#include <chasm/pipeline.hpp>
+#include <chasm/parser.hpp>
+#include <chasm/lexer.hpp>
+
+#include "benchmarks.hpp"
+#include "corpus.hpp"
+#include "harness.hpp"
+
+
+namespace bench
+{
+	namespace
+	{
+		using namespace chasm;
+
+		//
+		// Synthetic programs of increasing size, in procedures. The largest still fits the
+		// 12-bit address space so every stage, generation included, runs on all of them.
+		//
+		constexpr std::array<size_t, 4> PROGRAM_SIZES = { 4, 16, 64, 128 };
+
+		//
+		// Random ROMs in bytes, up to the whole memory above the default load address
+		//
+		constexpr std::array<size_t, 4> ROM_SIZES = { 512, 1024, 2048, arch::MAX_PROGRAM_SIZE };
+
+		//
+		// Copies of the same instruction generated by the encoder benchmarks
+		//
+		constexpr size_t ENCODE_REPEAT = 1024;
+
+		struct encoded_instruction
+		{
+			std::string_view mnemonic;
+			std::string_view instruction;
+		};
+
+		constexpr std::array ENCODED_INSTRUCTIONS = std::to_array<encoded_instruction>({
+			{ "add",     "add r1, r2" },
+			{ "sub",     "sub r1, r2" },
+			{ "suba",    "suba r4, rf" },
+			{ "or",      "or r2, r3" },
+			{ "and",     "and r2, r3" },
+			{ "xor",     "xor r2, r3" },
+			{ "shr",     "shr r2" },
+			{ "shl",     "shl r2" },
+			{ "rdump",   "rdump r2" },
+			{ "rload",   "rload r2" },
+			{ "mov",     "mov ra, 0x69" },
+			{ "draw",    "draw r1, r2, 0x5" },
+			{ "cls",     "cls" },
+			{ "rand",    "rand r2, 0x70" },
+			{ "bcd",     "bcd r4" },
+			{ "wkey",    "wkey r9" },
+			{ "ske",     "ske rd" },
+			{ "skne",    "skne rd" },
+			{ "ret",     "ret" },
+			{ "jmp",     "jmp @main" },
+			{ "call",    "call $p" },
+			{ "se",      "se r7, r8" },
+			{ "sne",     "sne r7, r8" },
+			{ "inc",     "inc rd" },
+			{ "ldf",     "ldf rf" },
+			{ "exit",    "exit" },
+			{ "scrd",    "scrd 4" },
+			{ "scrl",    "scrl" },
+			{ "scrr",    "scrr" },
+			{ "high",    "high" },
+			{ "low",     "low" },
+			{ "ldfs",    "ldfs rf" },
+			{ "saverpl", "saverpl r6" },
+			{ "loadrpl", "loadrpl r9" },
+			{ "swp",     "swp r1, r2" }
+		});
+
+		std::vector<token> tokens_of(std::string source)
+		{
+			return lexer(std::move(source)).enumerate_tokens();
+		}
+
+		ast::abstract_tree tree_of(std::string source)
+		{
+			return parser(tokens_of(std::move(source))).make_tree();
+		}
+
+		std::vector<uint8_t> assemble(std::string source)
+		{
+			return tree_of(std::move(source)).generate();
+		}
+
+		//
+		// Stream buffer dropping whatever is written to it, the disassembly printer writes to std::cout
+		//
+		class null_buffer final : public std::streambuf
+		{
+		protected:
+			int_type overflow(int_type c) override
+			{
+				return traits_type::not_eof(c);
+			}
+
+			std::streamsize xsputn(const char*, std::streamsize count) override
+			{
+				return count;
+			}
+		};
+
+		void add_front_end()
+		{
+			for (const auto procedures : PROGRAM_SIZES)
+			{
+				const auto source = synthetic_program({ .procedures = procedures });
+				const auto tokens = tokens_of(source);
+
+				add(std::format("lexer/next_token/{}", procedures), [source]
+				{
+					size_t count = 0;
+
+					lexer(std::string(source)).enumerate_tokens([&](token&&)
+					{
+						++count;
+						return true;
+					});
+
+					keep(count);
+				}, source.size(), tokens.size());
+
+				add(std::format("parser/make_tree/{}", procedures), [tokens]
+				{
+					auto tree = parser(std::vector(tokens)).make_tree();
+					keep(tree.branches().size());
+				}, source.size(), tokens.size());
+
+				auto tree = std::make_shared<ast::abstract_tree>(tree_of(source));
+
+				add(std::format("symbol_sanitizer/traverse/{}", procedures), [tree]
+				{
+					symbol_sanitizer(false).traverse(*tree);
+					keep(tree->branches().size());
+				}, source.size(), tree->branches().size());
+			}
+		}
+
+		void add_generator()
+		{
+			for (const auto& [mnemonic, instruction] : ENCODED_INSTRUCTIONS)
+			{
+				std::string source = "proc p\n    ret\nendp p\n.main:\n";
+
+				for (size_t i = 0; i < ENCODE_REPEAT; ++i)
+					std::format_to(std::back_inserter(source), "    {}\n", instruction);
+
+				auto tree = std::make_shared<ast::abstract_tree>(tree_of(source));
+
+				add(std::format("generator/encode_{}", mnemonic), [tree]
+				{
+					generator g;
+					keep(g.generate(*tree).size());
+				}, 0, ENCODE_REPEAT);
+			}
+
+			for (const auto procedures : PROGRAM_SIZES)
+			{
+				const auto source = synthetic_program({ .procedures = procedures });
+				auto tree = std::make_shared<ast::abstract_tree>(tree_of(source));
+
+				add(std::format("generator/generate/{}", procedures), [tree]
+				{
+					generator g;
+					keep(g.generate(*tree).size());
+				}, source.size(), tree->branches().size());
+			}
+		}
+
+		void add_disassembler()
+		{
+			for (const auto procedures : PROGRAM_SIZES)
+			{
+				const auto rom = assemble(synthetic_program({ .procedures = procedures }));
+				const auto base = options::arg<arch::addr>("relocate");
+
+				//
+				// ds_next_instruction is reached through the analysis of the whole ROM
+				//
+				add(std::format("disassembler/ds_next_instruction/{}", procedures), [rom, base]
+				{
+					auto graph = ds::disassembler(rom, base).get_graph();
+					keep(graph.get_procedures().size());
+				}, rom.size(), rom.size() / sizeof(arch::opcode));
+
+				add(std::format("disassembly_interface/print_disassembly/{}", procedures), [rom, base]
+				{
+					null_buffer discard;
+
+					ds::disassembly_interface interface(ds::disassembler(rom, base).get_graph());
+
+					auto* const previous = std::cout.rdbuf(&discard);
+					interface.print_disassembly();
+					std::cout.rdbuf(previous);
+				}, rom.size(), rom.size() / sizeof(arch::opcode));
+
+				auto graph = std::make_shared<const ds::disassembly_graph>(ds::disassembler(rom, base).get_graph());
+
+				add(std::format("disassembly_renderer/render_listing/{}", procedures), [graph]
+				{
+					keep(ds::render_listing(*graph).size());
+				}, rom.size(), rom.size() / sizeof(arch::opcode));
+			}
+		}
+
+		void add_disassembler_roms()
+		{
+			for (const auto size : ROM_SIZES)
+			{
+				const auto base = options::arg<arch::addr>("relocate");
+				const auto rom = synthetic_rom({ .size = size }, base);
+
+				add(std::format("disassembler/rom/{}", size), [rom, base]
+				{
+					auto graph = ds::disassembler(rom, base).get_graph();
+					keep(graph.get_procedures().size());
+				}, rom.size(), rom.size() / sizeof(arch::opcode));
+
+				add(std::format("disassembler/threads/{}", size), [rom, base]
+				{
+					auto graph = ds::disassembler(rom, base, ds::disassembly_mode::recursive, 4).get_graph();
+					keep(graph.get_procedures().size());
+				}, rom.size(), rom.size() / sizeof(arch::opcode));
+
+				add(std::format("disassembler/linear/{}", size), [rom, base]
+				{
+					auto graph = ds::disassembler(rom, base, ds::disassembly_mode::linear).get_graph();
+					keep(graph.get_paths().size());
+				}, rom.size(), rom.size() / sizeof(arch::opcode));
+
+				add(std::format("disassembler/hybrid/{}", size), [rom, base]
+				{
+					auto graph = ds::disassembler(rom, base, ds::disassembly_mode::hybrid).get_graph();
+					keep(graph.get_procedures().size());
+				}, rom.size(), rom.size() / sizeof(arch::opcode));
+			}
+		}
+
+		void add_output_formats()
+		{
+			const auto rom = assemble(synthetic_program({ .procedures = PROGRAM_SIZES.back() }));
+
+			for (const auto fmt : { output::format::ihex,
+									output::format::c_array,
+									output::format::base64,
+									output::format::hexdump })
+			{
+				add(std::format("output/encode_{}", output::name(fmt)), [rom, fmt]
+				{
+					keep(output::encode(fmt, rom).size());
+				}, rom.size(), 1);
+			}
+		}
+
+		//
+		// Whole assembly of a source to a ROM, sequential and pipelined
+		//
+		void add_end_to_end()
+		{
+			for (const auto procedures : PROGRAM_SIZES)
+			{
+				const auto source = synthetic_program({ .procedures = procedures });
+
+				add(std::format("assemble/sequential/{}", procedures), [source]
+				{
+					keep(assemble(source).size());
+				}, source.size(), 1);
+
+				add(std::format("assemble/pipelined/{}", procedures), [source]
+				{
+					keep(assemble_pipelined(std::string(source)).size());
+				}, source.size(), 1);
+			}
+		}
+	}
+
+	void register_benchmarks()
+	{
+		add_front_end();
+		add_generator();
+		add_disassembler();
+		add_disassembler_roms();
+		add_output_formats();
+		add_end_to_end();
+	}
+}
@@ -0,0 +1,14 @@
+#ifndef CHASM_BENCH_BENCHMARKS_HPP
+#define CHASM_BENCH_BENCHMARKS_HPP
+
+
+namespace bench
+{
+	//
+	// Adds every chasm benchmark to the registry, the options must have been parsed
+	//
+	void register_benchmarks();
+}
+
+
+#endif //CHASM_BENCH_BENCHMARKS_HPP
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <format>
+#include <random>
+#include <array>
+
+#include "corpus.hpp"
+
+
+namespace bench
+{
+	namespace
+	{
+		class random_source
+		{
+		public:
+			explicit random_source(uint32_t seed)
+				: rng(seed)
+			{}
+
+			//
+			// Uniform enough in [0, n) for inputs that only have to be varied, not unbiased
+			//
+			uint32_t pick(size_t n)
+			{
+				return n == 0 ? 0 : static_cast<uint32_t>(rng() % n);
+			}
+
+			bool chance(unsigned int percent)
+			{
+				return pick(100) < percent;
+			}
+
+		private:
+			std::mt19937 rng;
+		};
+
+		constexpr auto MAX_SPRITE_ROWS = 8;
+
+		void emit_instruction(std::string& source, random_source& rng, const program_parameters& params)
+		{
+			auto out = std::back_inserter(source);
+
+			const auto x = rng.pick(16);
+			const auto y = rng.pick(16);
+			const auto imm = rng.pick(256);
+
+			switch (rng.pick(12))
+			{
+				case 0:  std::format_to(out, "    mov r{:x}, 0x{:02X}\n", x, imm); break;
+				case 1:  std::format_to(out, "    add r{:x}, r{:x}\n", x, y); break;
+				case 2:  std::format_to(out, "    add r{:x}, {}\n", x, imm); break;
+				case 3:  std::format_to(out, "    xor r{:x}, r{:x}\n", x, y); break;
+				case 4:  std::format_to(out, "    shr r{:x}\n", x); break;
+				case 5:  std::format_to(out, "    rand r{:x}, 0x{:02X}\n", x, imm); break;
+				case 6:  std::format_to(out, "    sne r{:x}, r{:x}\n", x, y); break;
+				case 7:  std::format_to(out, "    mov dt, r{:x} ;; timer\n", x); break;
+
+				case 8:
+					if (params.sprites > 0)
+						std::format_to(out, "    mov ar, #s{}\n", rng.pick(params.sprites));
+					else
+						std::format_to(out, "    ldf r{:x}\n", x);
+					break;
+
+				case 9:
+					if (params.sprites > 0)
+						std::format_to(out, "    draw r{:x}, r{:x}, #s{}\n", x, y, rng.pick(params.sprites));
+					else
+						std::format_to(out, "    draw r{:x}, r{:x}, 0x{:X}\n", x, y, rng.pick(16));
+					break;
+
+				default:
+					if (params.defines > 0)
+						std::format_to(out, "    {} r{:x}, K{}\n", rng.chance(50) ? "mov" : "add", x, rng.pick(params.defines));
+					else
+						std::format_to(out, "    and r{:x}, r{:x}\n", x, y);
+					break;
+			}
+		}
+
+		void emit_procedure(std::string& source, random_source& rng, const program_parameters& params, size_t index)
+		{
+			auto out = std::back_inserter(source);
+
+			std::format_to(out, "proc p{}\n.loop:\n", index);
+
+			const auto count = std::max<size_t>(1, params.instructions / 2 + rng.pick(params.instructions + 1));
+
+			std::vector<size_t> labels;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (rng.chance(params.label_density))
+				{
+					std::format_to(out, ".l{}:\n", i);
+					labels.push_back(i);
+				}
+
+				emit_instruction(source, rng, params);
+			}
+
+			//
+			// every label is the target of a conditional jump
+			//
+			for (const auto label : labels)
+				std::format_to(out, "    se r{:x}, {}\n    jmp @l{}\n", rng.pick(16), rng.pick(256), label);
+
+			if (index > 0)
+				std::format_to(out, "    call $p{}\n", index - 1);
+
+			std::format_to(out, "    se r{:x}, 0\n    jmp @loop\n    ret\nendp p{}\n", rng.pick(16), index);
+		}
+
+		void put_opcode(std::vector<uint8_t>& rom, size_t offset, arch::opcode opcode)
+		{
+			rom[offset] = static_cast<uint8_t>(opcode >> 8);
+			rom[offset + 1] = static_cast<uint8_t>(opcode & 0xFF);
+		}
+
+		constexpr std::array<uint8_t, 9> ALU_OPERATIONS = { 0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0xE };
+		constexpr std::array<uint8_t, 10> REGISTER_OPERATIONS = { 0x07, 0x15, 0x18, 0x1E, 0x29, 0x30, 0x55, 0x65, 0x75, 0x85 };
+
+		arch::opcode random_skip(random_source& rng)
+		{
+			const auto x = static_cast<arch::opcode>(rng.pick(16));
+			const auto y = static_cast<arch::opcode>(rng.pick(16));
+
+			switch (rng.pick(6))
+			{
+				case 0:  return 0x3000 | (x << 8) | rng.pick(256);
+				case 1:  return 0x4000 | (x << 8) | rng.pick(256);
+				case 2:  return 0x5000 | (x << 8) | (y << 4);
+				case 3:  return 0x9000 | (x << 8) | (y << 4);
+				case 4:  return 0xE09E | (x << 8);
+				default: return 0xE0A1 | (x << 8);
+			}
+		}
+
+		//
+		// Any instruction but skips and returns
+		//
+		arch::opcode random_operation(random_source& rng, arch::addr base, size_t size)
+		{
+			const auto x = static_cast<arch::opcode>(rng.pick(16));
+			const auto y = static_cast<arch::opcode>(rng.pick(16));
+			const auto nn = static_cast<arch::opcode>(rng.pick(256));
+
+			switch (rng.pick(8))
+			{
+				case 0:  return 0x6000 | (x << 8) | nn;
+				case 1:  return 0x7000 | (x << 8) | nn;
+				case 2:  return 0x8000 | (x << 8) | (y << 4) | ALU_OPERATIONS[rng.pick(ALU_OPERATIONS.size())];
+				case 3:  return 0xC000 | (x << 8) | nn;
+				case 4:  return 0xD000 | (x << 8) | (y << 4) | rng.pick(16);
+				case 5:  return 0xF000 | (x << 8) | REGISTER_OPERATIONS[rng.pick(REGISTER_OPERATIONS.size())];
+				case 6:  return 0xA000 | static_cast<arch::opcode>(base + rng.pick(size));
+				default: return 0x00E0;
+			}
+		}
+	}
+
+	std::string synthetic_program(const program_parameters& params)
+	{
+		random_source rng(params.seed);
+
+		std::string source;
+		auto out = std::back_inserter(source);
+
+		for (size_t s = 0; s < params.sprites; ++s)
+		{
+			std::format_to(out, "sprite s{} [", s);
+
+			const auto rows = 1 + rng.pick(MAX_SPRITE_ROWS);
+
+			for (size_t r = 0; r < rows; ++r)
+				std::format_to(out, "{}{}", r == 0 ? "" : ", ", rng.pick(256));
+
+			source += "]\n";
+		}
+
+		for (size_t d = 0; d < params.defines; ++d)
+			std::format_to(out, "define K{} 0x{:02X}\n", d, rng.pick(256));
+
+		size_t procedures = 0;
+
+		while (procedures < params.procedures || source.size() < params.min_size)
+			emit_procedure(source, rng, params, procedures++);
+
+		source += ".main:\n";
+
+		//
+		// each procedure calls the previous one, calling the last one runs them all
+		//
+		if (procedures > 0)
+			std::format_to(out, "    call $p{}\n", procedures - 1);
+
+		source += ".end:\n    jmp @end\n";
+
+		return source;
+	}
+
+	std::vector<uint8_t> synthetic_rom(const rom_parameters& params, arch::addr base)
+	{
+		constexpr size_t ENTRY_SIZE = 2 * sizeof(arch::opcode);
+		constexpr size_t MIN_PROCEDURE_INSTRUCTIONS = 2;
+
+		random_source rng(params.seed);
+
+		const size_t address_space = base < 0x1000 ? 0x1000 - base : 0;
+		const auto size = std::clamp<size_t>(params.size, ENTRY_SIZE * 2, std::max(address_space, ENTRY_SIZE * 2)) & ~size_t(1);
+
+		const auto words = (size - ENTRY_SIZE) / sizeof(arch::opcode);
+		const auto data_words = std::min(words * params.data_density / 100, words - MIN_PROCEDURE_INSTRUCTIONS);
+		const auto code_words = words - data_words;
+
+		const auto procedures = std::clamp<size_t>(params.procedures ? params.procedures : size / 64,
+												   1,
+												   code_words / MIN_PROCEDURE_INSTRUCTIONS);
+
+		//
+		// Lays the procedures out first so calls can target any of them
+		//
+		struct procedure_layout
+		{
+			size_t offset;
+			size_t instructions;
+		};
+
+		std::vector<procedure_layout> layout;
+		std::vector<size_t> gaps;
+
+		size_t offset = ENTRY_SIZE;
+		size_t code_left = code_words;
+		size_t data_left = data_words;
+
+		for (size_t p = 0; p < procedures; ++p)
+		{
+			const auto remaining = procedures - p - 1;
+			const auto average = code_left / (remaining + 1);
+
+			const auto instructions = remaining == 0
+				? code_left
+				: std::clamp<size_t>(average / 2 + rng.pick(average + 1),
+									 MIN_PROCEDURE_INSTRUCTIONS,
+									 code_left - remaining * MIN_PROCEDURE_INSTRUCTIONS);
+
+			const auto gap = remaining == 0 ? data_left : std::min<size_t>(data_left, rng.pick(2 * data_left / (remaining + 1) + 1));
+
+			layout.push_back({ offset, instructions });
+			gaps.push_back(gap);
+
+			offset += (instructions + gap) * sizeof(arch::opcode);
+			code_left -= instructions;
+			data_left -= gap;
+		}
+
+		std::vector<uint8_t> rom(size);
+
+		put_opcode(rom, 0, static_cast<arch::opcode>(0x2000 | (base + layout.front().offset)));
+		put_opcode(rom, 2, static_cast<arch::opcode>(0x1000 | (base + 2)));
+
+		for (size_t p = 0; p < procedures; ++p)
+		{
+			const auto [start, instructions] = layout[p];
+			const auto last = instructions - 1;
+
+			//
+			// the instruction chaining to the next procedure
+			//
+			const auto chain = rng.pick(last);
+
+			//
+			// jumps only follow "se rX, NN" skips, the disassembler following both of their
+			// outcomes, so the instructions after them and the call chaining to the next procedure
+			// stay reachable
+			//
+			bool after_skip = false;
+
+			for (size_t i = 0; i < last; ++i)
+			{
+				arch::opcode opcode;
+				bool skip = false;
+
+				if (i == chain && p + 1 < procedures)
+					opcode = static_cast<arch::opcode>(0x2000 | (base + layout[p + 1].offset));
+				else if (after_skip && rng.chance(50))
+					opcode = static_cast<arch::opcode>(0x1000 | (base + start + rng.pick(instructions) * sizeof(arch::opcode)));
+				else if (i + 1 < last && rng.chance(15))
+				{
+					opcode = random_skip(rng);
+					skip = true;
+				}
+				else if (rng.chance(5))
+					opcode = static_cast<arch::opcode>(0x2000 | (base + layout[rng.pick(procedures)].offset));
+				else
+					opcode = random_operation(rng, base, size);
+
+				after_skip = skip && (opcode >> 12) == 0x3;
+
+				put_opcode(rom, start + i * sizeof(arch::opcode), opcode);
+			}
+
+			put_opcode(rom, start + last * sizeof(arch::opcode), 0x00EE);
+
+			for (size_t d = 0; d < gaps[p] * sizeof(arch::opcode); ++d)
+				rom[start + instructions * sizeof(arch::opcode) + d] = static_cast<uint8_t>(rng.pick(256));
+		}
+
+		return rom;
+	}
+}
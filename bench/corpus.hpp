@@ -0,0 +1,83 @@
+#ifndef CHASM_BENCH_CORPUS_HPP
+#define CHASM_BENCH_CORPUS_HPP
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <chasm/arch.hpp>
+
+
+namespace bench
+{
+	namespace arch = chasm::arch;
+
+	//
+	// Only the raw output of std::mt19937 is used by the generators, its sequence being fixed by
+	// the standard, so the same parameters give the same program or ROM with every standard library
+	// and benchmark runs can be compared between machines and commits.
+	//
+
+	struct program_parameters
+	{
+		size_t procedures = 16;
+
+		//
+		// average instructions per procedure, the actual count varies from half to one and a half of it
+		//
+		size_t instructions = 8;
+
+		//
+		// percentage of the instructions preceded by a label, each label being the target of a jump
+		//
+		unsigned int label_density = 10;
+
+		size_t sprites = 8;
+		size_t defines = 0;
+
+		//
+		// procedures are added past the requested count until the source is at least this many bytes
+		//
+		size_t min_size = 0;
+
+		uint32_t seed = 0xC8;
+	};
+
+	//
+	// Valid chasm program made of procedures looping over their instructions and calling the previous
+	// procedure, followed by a .main calling the last one. Sprites and constants are declared at the
+	// top and used by the instructions.
+	//
+	[[nodiscard]] std::string synthetic_program(const program_parameters& params);
+
+	struct rom_parameters
+	{
+		//
+		// clamped to the memory above the load address, jumps and calls only reach 12-bit addresses
+		//
+		size_t size = 1024;
+
+		//
+		// zero for one procedure per 64 bytes
+		//
+		size_t procedures = 0;
+
+		//
+		// percentage of the ROM filled with data bytes between procedures, never reached by the code
+		//
+		unsigned int data_density = 10;
+
+		uint32_t seed = 0xC8;
+	};
+
+	//
+	// Well-formed ROM loaded at the given address: an entry point calling the first procedure, then
+	// procedures of decodable instructions, each calling the next one and jumping, skipping and
+	// calling around, and always ending with a return.
+	//
+	[[nodiscard]] std::vector<uint8_t> synthetic_rom(const rom_parameters& params, arch::addr base = 0x200);
+}
+
+
+#endif //CHASM_BENCH_CORPUS_HPP
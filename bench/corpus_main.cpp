@@ -0,0 +1,129 @@
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <format>
+#include <string>
+
+#include <chasm/chasm_exception.hpp>
+#include <chasm/cxxopts.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/log.hpp>
+
+#include "corpus.hpp"
+
+
+namespace
+{
+	//
+	// "corpus/prog.c8" becomes "corpus/prog_0003.c8" when several files are generated
+	//
+	std::filesystem::path numbered(const std::filesystem::path& path, size_t index, size_t count)
+	{
+		if (count == 1 || chasm::is_stdio(path))
+			return path;
+
+		auto name = path.stem().string() + std::format("_{:04}", index);
+		return path.parent_path() / (name + path.extension().string());
+	}
+
+	void write(const std::filesystem::path& path, std::span<const char> content)
+	{
+		if (chasm::is_stdio(path))
+			return chasm::write_stdout(content);
+
+		if (path.has_parent_path())
+			std::filesystem::create_directories(path.parent_path());
+
+		std::ofstream os(path, std::ios::binary);
+
+		if (!os)
+			throw chasm::chasm_exception("Could not open file \"{}\" for writing", path.string());
+
+		os.write(content.data(), static_cast<std::streamsize>(content.size()));
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	cxxopts::Options opts { "chasm_corpus", "Generates seeded chasm programs and CHIP-8 ROMs of the requested shape" };
+
+	opts.add_options()
+			("h,help", "Show help message")
+			("out", "Output file, numbered when several are generated, - for the standard output", cxxopts::value<std::string>()->default_value("-"))
+			("count", "Number of files to generate, each from the next seed", cxxopts::value<size_t>()->default_value("1"))
+			("seed", "Seed of the first file, the same seed always generates the same file", cxxopts::value<uint32_t>()->default_value("0xC8"))
+			("procedures", "Procedures of a program, or of a ROM (0 for one per 64 bytes)", cxxopts::value<size_t>())
+			("instructions", "Average instructions per procedure of a program", cxxopts::value<size_t>()->default_value("8"))
+			("label-density", "Percentage of the instructions of a program preceded by a jump target label", cxxopts::value<unsigned int>()->default_value("10"))
+			("sprites", "Sprites declared by a program", cxxopts::value<size_t>()->default_value("8"))
+			("defines", "Constants declared by a program", cxxopts::value<size_t>()->default_value("0"))
+			("size", "Minimum size in bytes of a program source, procedures are added until it is reached", cxxopts::value<size_t>()->default_value("0"))
+			("rom", "Generate ROMs of the given size in bytes instead of programs", cxxopts::value<size_t>())
+			("data-density", "Percentage of a ROM filled with unreachable data bytes", cxxopts::value<unsigned int>()->default_value("10"))
+			("relocate", "Address the ROMs are loaded at", cxxopts::value<chasm::arch::addr>()->default_value("0x200"));
+
+	try
+	{
+		const auto args = opts.parse(argc, argv);
+
+		if (args.count("help"))
+		{
+			std::cout << opts.help() << std::endl;
+			return EXIT_SUCCESS;
+		}
+
+		const auto out = std::filesystem::path(args["out"].as<std::string>());
+		const auto count = args["count"].as<size_t>();
+		const auto seed = args["seed"].as<uint32_t>();
+
+		if (count > 1 && chasm::is_stdio(out))
+			throw chasm::chasm_exception("Several files cannot be written to the standard output, give an output file to number");
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto file = numbered(out, i, count);
+			const auto file_seed = static_cast<uint32_t>(seed + i);
+
+			if (args.count("rom"))
+			{
+				const auto rom = bench::synthetic_rom({
+					.size = args["rom"].as<size_t>(),
+					.procedures = args.count("procedures") ? args["procedures"].as<size_t>() : 0,
+					.data_density = args["data-density"].as<unsigned int>(),
+					.seed = file_seed
+				}, args["relocate"].as<chasm::arch::addr>());
+
+				write(file, { reinterpret_cast<const char*>(rom.data()), rom.size() });
+			}
+			else
+			{
+				const auto program = bench::synthetic_program({
+					.procedures = args.count("procedures") ? args["procedures"].as<size_t>() : 16,
+					.instructions = args["instructions"].as<size_t>(),
+					.label_density = args["label-density"].as<unsigned int>(),
+					.sprites = args["sprites"].as<size_t>(),
+					.defines = args["defines"].as<size_t>(),
+					.min_size = args["size"].as<size_t>(),
+					.seed = file_seed
+				});
+
+				write(file, program);
+			}
+		}
+	}
+	catch (cxxopts::exceptions::exception& error)
+	{
+		chasm::log::error(error.what());
+		std::cout << opts.help() << std::endl;
+
+		return EXIT_FAILURE;
+	}
+	catch (std::exception& error)
+	{
+		chasm::log::error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
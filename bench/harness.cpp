@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <format>
+#include <chrono>
+
+#include <chasm/version.hpp>
+
+#include "harness.hpp"
+
+
+namespace bench
+{
+	namespace
+	{
+		using clock = std::chrono::steady_clock;
+
+		volatile size_t sink = 0;
+
+		double sample_ns(const benchmark& b, uint64_t iterations)
+		{
+			const auto start = clock::now();
+
+			for (uint64_t i = 0; i < iterations; ++i)
+				b.body();
+
+			return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+		}
+
+		//
+		// Doubles the operations of a sample until it lasts long enough to be measured
+		//
+		uint64_t calibrate(const benchmark& b, double min_sample_ns)
+		{
+			uint64_t iterations = 1;
+
+			for (;;)
+			{
+				const auto elapsed = sample_ns(b, iterations);
+
+				if (elapsed >= min_sample_ns)
+					return iterations;
+
+				if (elapsed * 10 < min_sample_ns)
+					iterations *= 10;
+				else
+					iterations *= 2;
+			}
+		}
+
+		//
+		// Value of a "key": value pair of the single line object of a result
+		//
+		std::optional<std::string_view> json_value(std::string_view line, std::string_view key)
+		{
+			const auto quoted = std::format("\"{}\": ", key);
+			auto begin = line.find(quoted);
+
+			if (begin == std::string_view::npos)
+				return std::nullopt;
+
+			begin += quoted.size();
+
+			if (line[begin] == '"')
+			{
+				const auto end = line.find('"', begin + 1);
+				return line.substr(begin + 1, end - begin - 1);
+			}
+
+			return line.substr(begin, line.find_first_of(",}", begin) - begin);
+		}
+	}
+
+	std::vector<benchmark>& registry()
+	{
+		static std::vector<benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	void add(std::string name, std::function<void()> body, size_t bytes_per_op, size_t items_per_op)
+	{
+		registry().push_back({
+			.name = std::move(name),
+			.body = std::move(body),
+			.bytes_per_op = bytes_per_op,
+			.items_per_op = items_per_op
+		});
+	}
+
+	std::vector<result> run(const run_options& options)
+	{
+		std::vector<result> results;
+
+		for (const auto& b : registry())
+		{
+			if (!b.name.contains(options.filter))
+				continue;
+
+			const auto iterations = calibrate(b, options.min_sample_ms * 1e6);
+
+			std::vector<double> samples;
+
+			for (unsigned int i = 0; i < std::max(options.samples, 1u); ++i)
+				samples.push_back(sample_ns(b, iterations) / static_cast<double>(iterations));
+
+			std::ranges::sort(samples);
+
+			const auto ns_per_op = samples[samples.size() / 2];
+
+			const auto& r = results.emplace_back(result {
+				.name = b.name,
+				.iterations = iterations,
+				.ns_per_op = ns_per_op,
+				.mb_per_s = static_cast<double>(b.bytes_per_op) / ns_per_op * 1e3,
+				.items_per_s = static_cast<double>(b.items_per_op) / ns_per_op * 1e9
+			});
+
+			std::cout << std::format("{:<48} {:>14.1f} ns/op {:>10.2f} MB/s {:>14.1f} items/s\n",
+									 r.name,
+									 r.ns_per_op,
+									 r.mb_per_s,
+									 r.items_per_s);
+		}
+
+		return results;
+	}
+
+	std::string to_json(const std::vector<result>& results)
+	{
+		std::string json = std::format("{{\n  \"version\": \"{}\",\n  \"benchmarks\": [", chasm::version);
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& r = results[i];
+
+			std::format_to(std::back_inserter(json),
+						   "{}\n    {{ \"name\": \"{}\", \"iterations\": {}, \"ns_per_op\": {:.3f}, \"mb_per_s\": {:.3f}, \"items_per_s\": {:.3f} }}",
+						   i == 0 ? "" : ",",
+						   r.name,
+						   r.iterations,
+						   r.ns_per_op,
+						   r.mb_per_s,
+						   r.items_per_s);
+		}
+
+		json += "\n  ]\n}\n";
+
+		return json;
+	}
+
+	std::optional<std::vector<result>> load_json(const std::filesystem::path& path)
+	{
+		std::ifstream is(path);
+
+		if (!is)
+			return std::nullopt;
+
+		std::vector<result> results;
+
+		//
+		// to_json writes one result per line
+		//
+		for (std::string line; std::getline(is, line);)
+		{
+			const auto name = json_value(line, "name");
+			const auto ns_per_op = json_value(line, "ns_per_op");
+
+			if (!name || !ns_per_op)
+				continue;
+
+			results.push_back({ .name = std::string(*name), .ns_per_op = std::stod(std::string(*ns_per_op)) });
+		}
+
+		return results;
+	}
+
+	size_t compare(const std::vector<result>& baseline, const std::vector<result>& current, double threshold)
+	{
+		size_t regressions = 0;
+
+		std::cout << std::format("\n{:<48} {:>14} {:>14} {:>9}\n", "Benchmark", "Baseline ns", "Current ns", "Change");
+
+		for (const auto& r : current)
+		{
+			const auto base = std::ranges::find(baseline, r.name, &result::name);
+
+			if (base == baseline.end())
+				continue;
+
+			const auto change = (r.ns_per_op / base->ns_per_op - 1) * 100;
+			const bool regressed = change > threshold;
+
+			regressions += regressed;
+
+			std::cout << std::format("{:<48} {:>14.1f} {:>14.1f} {:>+8.1f}%{}\n",
+									 r.name,
+									 base->ns_per_op,
+									 r.ns_per_op,
+									 change,
+									 regressed ? "  <-- slower" : "");
+		}
+
+		return regressions;
+	}
+
+	void keep(size_t value)
+	{
+		sink = sink + value;
+	}
+}
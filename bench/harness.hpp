@@ -0,0 +1,82 @@
+#ifndef CHASM_BENCH_HARNESS_HPP
+#define CHASM_BENCH_HARNESS_HPP
+
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace bench
+{
+	///
+	/// A benchmark runs its body over and over, the body doing one operation per call.
+	///
+	/// Operations are counted in bytes and items (tokens, instructions, ROMs...) so results
+	/// read as MB/s and items/s, whatever the time an operation takes.
+	///
+	struct benchmark
+	{
+		std::string name;
+		std::function<void()> body;
+
+		size_t bytes_per_op = 0;
+		size_t items_per_op = 1;
+	};
+
+	struct result
+	{
+		std::string name;
+		uint64_t iterations = 0;
+		double ns_per_op = 0;
+		double mb_per_s = 0;
+		double items_per_s = 0;
+	};
+
+	struct run_options
+	{
+		std::string filter;
+
+		//
+		// minimum duration of a sample, the operation count of a sample is sized after it
+		//
+		double min_sample_ms = 20;
+		unsigned int samples = 7;
+	};
+
+	//
+	// Registered benchmarks, in registration order
+	//
+	std::vector<benchmark>& registry();
+
+	void add(std::string name, std::function<void()> body, size_t bytes_per_op = 0, size_t items_per_op = 1);
+
+	//
+	// Median of the samples of every benchmark whose name contains the filter
+	//
+	[[nodiscard]] std::vector<result> run(const run_options& options);
+
+	[[nodiscard]] std::string to_json(const std::vector<result>& results);
+
+	//
+	// Reads back a file written from to_json, nothing if it cannot be read
+	//
+	[[nodiscard]] std::optional<std::vector<result>> load_json(const std::filesystem::path& path);
+
+	//
+	// Prints the change of every benchmark present in both runs,
+	// returns the number of benchmarks slower than the threshold (in percent)
+	//
+	size_t compare(const std::vector<result>& baseline, const std::vector<result>& current, double threshold);
+
+	//
+	// Keeps the computation of a value from being optimized away
+	//
+	void keep(size_t value);
+}
+
+
+#endif //CHASM_BENCH_HARNESS_HPP
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <chasm/chasm_exception.hpp>
+#include <chasm/options.hpp>
+#include <chasm/cxxopts.hpp>
+#include <chasm/log.hpp>
+
+#include "benchmarks.hpp"
+#include "harness.hpp"
+
+
+int main(int argc, char** argv)
+{
+	cxxopts::Options opts { "chasm_bench", "Microbenchmarks of the chasm assembler and disassembler" };
+
+	opts.add_options()
+			("h,help", "Show help message")
+			("filter", "Only run the benchmarks whose name contains the given text", cxxopts::value<std::string>()->default_value(""))
+			("min-time", "Minimum duration in milliseconds of each of the samples of a benchmark", cxxopts::value<double>()->default_value("20"))
+			("samples", "Number of samples per benchmark, the median is reported", cxxopts::value<unsigned int>()->default_value("7"))
+			("json", "Write the results to the given JSON file", cxxopts::value<std::string>())
+			("compare", "Compare the results with a JSON file written by a previous run", cxxopts::value<std::string>())
+			("threshold", "Slowdown in percent above which a compared benchmark fails the run", cxxopts::value<double>()->default_value("10"));
+
+	try
+	{
+		const auto args = opts.parse(argc, argv);
+
+		if (args.count("help"))
+		{
+			std::cout << opts.help() << std::endl;
+			return EXIT_SUCCESS;
+		}
+
+		//
+		// the assembler reads its settings from the chasm options, the benchmarks target the
+		// SUPER-CHIP so its instructions do not log a warning on every operation
+		//
+		const char* chasm_argv[] = { "chasm_bench", "--super" };
+		chasm::options::parse(sizeof(chasm_argv) / sizeof(char*), chasm_argv);
+
+		bench::register_benchmarks();
+
+		const auto results = bench::run({
+			.filter = args["filter"].as<std::string>(),
+			.min_sample_ms = args["min-time"].as<double>(),
+			.samples = args["samples"].as<unsigned int>()
+		});
+
+		if (args.count("json"))
+		{
+			const auto path = args["json"].as<std::string>();
+			std::ofstream os(path);
+
+			if (!os)
+				throw chasm::chasm_exception("Could not open benchmark results file \"{}\" for writing", path);
+
+			os << bench::to_json(results);
+		}
+
+		if (args.count("compare"))
+		{
+			const auto path = args["compare"].as<std::string>();
+			const auto baseline = bench::load_json(path);
+
+			if (!baseline)
+				throw chasm::chasm_exception("Could not read benchmark results file \"{}\"", path);
+
+			const auto threshold = args["threshold"].as<double>();
+
+			if (const auto regressions = bench::compare(*baseline, results, threshold))
+			{
+				chasm::log::error("{} benchmarks are more than {}% slower than the baseline", regressions, threshold);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	catch (cxxopts::exceptions::exception& error)
+	{
+		chasm::log::error(error.what());
+		std::cout << opts.help() << std::endl;
+
+		return EXIT_FAILURE;
+	}
+	catch (std::exception& error)
+	{
+		chasm::log::error(error.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -233,7 +233,7 @@ namespace chasm::arch
 #define GET_OVERLOAD(_1, _2, _3, _4, OVERLOAD, ...) OVERLOAD
 #define ENCODE(...) EXPAND(GET_OVERLOAD(__VA_ARGS__, ENCODE_dXYN, ENCODE_dXNN, ENCODE_dNNN)(__VA_ARGS__))
 
-		constexpr opcode _00CN(imm imm4) { return ENCODE(0, 0xC, imm4); }
+		constexpr opcode _00CN(imm imm4) { return ENCODE(0x0, 0x0C0 | imm4); }
 		constexpr opcode _5XY0(reg rx, reg ry) { return ENCODE(0x5, rx, ry, 0x0); }
 		constexpr opcode _8XY0(reg rx, reg ry) { return ENCODE(0x8, rx, ry, 0x0); }
 		constexpr opcode _8XY1(reg rx, reg ry) { return ENCODE(0x8, rx, ry, 0x1); }
@@ -277,6 +277,18 @@ namespace chasm::arch
 		constexpr opcode _ANNN(arch::imm imm12) { return ENCODE(0xA, imm12); }
 		constexpr opcode _DXYN(reg rx, reg ry, imm imm4) { return ENCODE(0xD, rx, ry, imm4); }
 	}
+
+	//
+	// Operands extracted back from an opcode, the reverse of the encoders above
+	//
+	namespace dec
+	{
+		constexpr reg X(opcode op) { return static_cast<reg>((op & 0x0F00) >> 8); }
+		constexpr reg Y(opcode op) { return static_cast<reg>((op & 0x00F0) >> 4); }
+		constexpr imm N(opcode op) { return static_cast<imm>(op & 0x000F); }
+		constexpr imm NN(opcode op) { return static_cast<imm>(op & 0x00FF); }
+		constexpr addr NNN(opcode op) { return static_cast<addr>(op & 0x0FFF); }
+	}
 }
 
 #endif //CHASM_ARCH_HPP
@@ -3,11 +3,18 @@
 
 
 #include <vector>
+#include <memory>
 
 #include <chasm/ast_visitor.hpp>
 #include <chasm/statements.hpp>
 
 
+namespace chasm
+{
+	class incremental_state;
+	struct object_file;
+}
+
 namespace chasm::ast
 {
     class abstract_tree
@@ -15,14 +22,23 @@ namespace chasm::ast
 	public:
         explicit abstract_tree(std::vector<ast::statement>&& branches);
 
+		//
+		// The storage holds the text the tokens of the branches view
+		//
+		abstract_tree(std::vector<ast::statement>&& branches, std::shared_ptr<const void> storage_);
+
 		[[nodiscard]] std::vector<uint8_t> generate();
+		[[nodiscard]] std::vector<uint8_t> generate(incremental_state& state);
+		[[nodiscard]] object_file generate_object();
 		[[nodiscard]] const std::vector<ast::statement>& branches() const;
 
 	private:
-		void sanitize() const;
+		void sanitize(bool relocatable = false) const;
+		void sort_statements();
 
 	private:
 		std::vector<ast::statement> statements {};
+		std::shared_ptr<const void> storage;
     };
 }
 
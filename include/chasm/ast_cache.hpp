@@ -0,0 +1,36 @@
+#ifndef CHASM_AST_CACHE_HPP
+#define CHASM_AST_CACHE_HPP
+
+
+#include <filesystem>
+#include <optional>
+
+#include <chasm/hash.hpp>
+#include <chasm/ast.hpp>
+
+
+///
+/// Parsed trees serialized next to their source file (.c8a), so an unchanged source
+/// goes straight to code generation without being lexed and parsed again.
+///
+/// Token strings are interned in a pool and source locations are kept for diagnostics.
+/// A file is only used for the source content it was parsed from, compared by hash.
+///
+namespace chasm::ast_cache
+{
+	using key_type = hasher::value_type;
+
+	[[nodiscard]] std::filesystem::path path_for(const std::filesystem::path& source);
+
+	[[nodiscard]] key_type make_key(std::string_view source);
+
+	//
+	// Returns nothing when the file is missing, stale, corrupted or written by another chasm version
+	//
+	[[nodiscard]] std::optional<ast::abstract_tree> load(const std::filesystem::path& path, key_type source_key);
+
+	void store(const std::filesystem::path& path, key_type source_key, const ast::abstract_tree& tree);
+}
+
+
+#endif //CHASM_AST_CACHE_HPP
@@ -0,0 +1,132 @@
+#ifndef CHASM_BINARY_IO_HPP
+#define CHASM_BINARY_IO_HPP
+
+
+#include <string_view>
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <chasm/chasm_exception.hpp>
+
+
+namespace chasm
+{
+	///
+	/// Little-endian serialization helpers shared by the on-disk formats of chasm
+	///
+	class binary_writer
+	{
+	public:
+		template<std::integral T>
+		binary_writer& write(T value)
+		{
+			for (size_t i = 0; i < sizeof(T); ++i)
+				buffer.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8)));
+
+			return *this;
+		}
+
+		binary_writer& write(std::span<const uint8_t> bytes)
+		{
+			write(static_cast<uint32_t>(bytes.size()));
+			buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+
+			return *this;
+		}
+
+		binary_writer& write(std::string_view str)
+		{
+			return write(std::span(reinterpret_cast<const uint8_t*>(str.data()), str.size()));
+		}
+
+		binary_writer& write_raw(std::span<const uint8_t> bytes)
+		{
+			buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+			return *this;
+		}
+
+		[[nodiscard]] size_t size() const
+		{
+			return buffer.size();
+		}
+
+		[[nodiscard]] const std::vector<uint8_t>& data() const
+		{
+			return buffer;
+		}
+
+		[[nodiscard]] std::vector<uint8_t> release()
+		{
+			return std::move(buffer);
+		}
+
+	private:
+		std::vector<uint8_t> buffer;
+	};
+
+	class binary_reader
+	{
+	public:
+		explicit binary_reader(std::span<const uint8_t> bytes_)
+			: bytes(bytes_)
+		{}
+
+		template<std::integral T>
+		[[nodiscard]] T read()
+		{
+			ensure_available(sizeof(T));
+
+			uint64_t value = 0;
+
+			for (size_t i = 0; i < sizeof(T); ++i)
+				value |= static_cast<uint64_t>(bytes[offset + i]) << (i * 8);
+
+			offset += sizeof(T);
+
+			return static_cast<T>(value);
+		}
+
+		[[nodiscard]] std::span<const uint8_t> read_bytes()
+		{
+			return read_raw(read<uint32_t>());
+		}
+
+		[[nodiscard]] std::string_view read_string()
+		{
+			const auto str = read_bytes();
+			return { reinterpret_cast<const char*>(str.data()), str.size() };
+		}
+
+		[[nodiscard]] std::span<const uint8_t> read_raw(size_t count)
+		{
+			ensure_available(count);
+
+			const auto raw = bytes.subspan(offset, count);
+			offset += count;
+
+			return raw;
+		}
+
+		[[nodiscard]] bool exhausted() const
+		{
+			return offset >= bytes.size();
+		}
+
+	private:
+		void ensure_available(size_t count) const
+		{
+			if (count > bytes.size() - offset)
+				throw chasm_exception("Unexpected end of data while reading binary file at offset {}", offset);
+		}
+
+	private:
+		std::span<const uint8_t> bytes;
+		size_t offset = 0;
+	};
+}
+
+
+#endif //CHASM_BINARY_IO_HPP
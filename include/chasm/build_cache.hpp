@@ -0,0 +1,63 @@
+#ifndef CHASM_BUILD_CACHE_HPP
+#define CHASM_BUILD_CACHE_HPP
+
+
+#include <filesystem>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <chasm/hash.hpp>
+
+
+namespace chasm
+{
+	///
+	/// On-disk content-addressed cache of assembled binaries and their symbols file.
+	///
+	/// Entries are named after the key, every file is first written to a unique temporary
+	/// name then renamed over its final name, so concurrent invocations sharing the same
+	/// directory only ever see complete entries.
+	///
+	class build_cache
+	{
+	public:
+		using key_type = hasher::value_type;
+
+		struct entry
+		{
+			std::vector<uint8_t> binary;
+			std::optional<std::string> symbols;
+		};
+
+		build_cache(std::filesystem::path directory, uintmax_t max_size);
+		~build_cache() = default;
+
+		build_cache(const build_cache&) = delete;
+		build_cache(build_cache&&) = delete;
+		build_cache& operator=(const build_cache&) = delete;
+		build_cache& operator=(build_cache&&) = delete;
+
+		//
+		// key of a source assembled with the current command line options
+		//
+		[[nodiscard]] static key_type make_key(std::string_view source);
+
+		[[nodiscard]] std::optional<entry> lookup(key_type key, bool with_symbols) const;
+		void store(key_type key, const std::vector<uint8_t>& binary, const std::optional<std::string>& symbols) const;
+
+	private:
+		[[nodiscard]] std::filesystem::path entry_path(key_type key, std::string_view extension) const;
+		void evict() const;
+
+	private:
+		std::filesystem::path root;
+		uintmax_t max_size;
+	};
+}
+
+
+#endif //CHASM_BUILD_CACHE_HPP
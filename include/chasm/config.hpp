@@ -25,6 +25,8 @@ namespace chasm
 		void reset(std::string_view id);
 		void set(std::string_view id, int);
 
+		[[nodiscard]] const std::unordered_map<std::string_view, int>& values() const;
+
 		template<std::integral T>
 		[[nodiscard]] T get_as(std::string_view id) const
 		{
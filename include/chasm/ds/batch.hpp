@@ -0,0 +1,97 @@
+#ifndef CHASM_BATCH_HPP
+#define CHASM_BATCH_HPP
+
+
+#include <filesystem>
+#include <string_view>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <chasm/ds/disassembler.hpp>
+#include <chasm/arch.hpp>
+
+
+namespace chasm::ds
+{
+	struct batch_input
+	{
+		std::filesystem::path rom;
+
+		//
+		// path of the ROM under the directory it was found in, kept for its listing in the output directory
+		//
+		std::filesystem::path relative;
+	};
+
+	struct batch_result
+	{
+		std::filesystem::path rom;
+		std::filesystem::path listing;
+
+		//
+		// why the ROM could not be disassembled, nothing when its listing was written
+		//
+		std::optional<std::string> error;
+	};
+
+	//
+	// Extensions of the files taken from the directories given to a batch
+	//
+	constexpr std::string_view ROM_EXTENSIONS[] = { ".ch8", ".c8c", ".sc8" };
+
+	//
+	// Whether the name matches a pattern where '*' stands for any characters and '?' for one
+	//
+	[[nodiscard]] bool glob_matches(std::string_view pattern, std::string_view name);
+
+	//
+	// Expands the directories (searched recursively for ROMs), the patterns (their last component
+	// may hold '*' and '?') and the files given into the ROMs to disassemble, sorted and without
+	// duplicates. Throws when an argument matches nothing.
+	//
+	[[nodiscard]] std::vector<batch_input> expand_batch(std::span<const std::string> arguments);
+
+	///
+	/// Disassembles ROMs on up to `jobs` threads (0 for one per hardware thread) into chasm sources
+	/// assembling back to them. The listing of a ROM is written in the output directory under its
+	/// relative path, or next to it when no output directory is given, with the .c8 extension. A ROM
+	/// that fails does not stop the others, its error is kept in its result. ROMs whose listings would
+	/// be written to the same file all fail.
+	///
+	class disassembly_batch
+	{
+	public:
+		disassembly_batch(arch::addr base_, disassembly_mode mode_, std::optional<std::filesystem::path> output_dir_);
+		~disassembly_batch() = default;
+
+		disassembly_batch(const disassembly_batch&) = delete;
+		disassembly_batch(disassembly_batch&&) = delete;
+		disassembly_batch& operator=(const disassembly_batch&) = delete;
+		disassembly_batch& operator=(disassembly_batch&&) = delete;
+
+		//
+		// Results in the order of the inputs
+		//
+		[[nodiscard]] std::vector<batch_result> run(std::span<const batch_input> inputs, unsigned int jobs) const;
+
+		//
+		// One tab separated line per ROM: "ok", the ROM and its listing, or "failed", the ROM and the error
+		//
+		static void write_report(std::ostream& os, std::span<const batch_result> results);
+
+	private:
+		[[nodiscard]] std::filesystem::path listing_path(const batch_input& input) const;
+		[[nodiscard]] batch_result disassemble(const batch_input& input) const;
+
+	private:
+		arch::addr base;
+		disassembly_mode mode;
+		std::optional<std::filesystem::path> output_dir;
+	};
+}
+
+
+#endif //CHASM_BATCH_HPP
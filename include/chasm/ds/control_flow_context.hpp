@@ -2,7 +2,8 @@
 #define CHASM_CONTROL_FLOW_CONTEXT_HPP
 
 
-#include <unordered_set>
+#include <cstdint>
+#include <vector>
 #include <stack>
 
 #include <chasm/ds/paths.hpp>
@@ -10,6 +11,19 @@
 
 namespace chasm::ds
 {
+	///
+	/// One bit per address, sized on demand so small ROMs only pay for the memory they span.
+	///
+	class address_bitmap
+	{
+	public:
+		void set(arch::addr address);
+		[[nodiscard]] bool test(arch::addr address) const;
+
+	private:
+		std::vector<uint64_t> words;
+	};
+
 	class analysis_path : public path
 	{
 	public:
@@ -35,9 +49,15 @@ namespace chasm::ds
 		[[nodiscard]] const std::vector<analysis_path>& analyzed_paths() const;
 		void add_path(arch::addr);
 
+		//
+		// Instructions decoded by the paths of the procedure, past the first instruction of their path
+		//
+		void mark_instruction(arch::addr);
+		[[nodiscard]] bool has_instruction(arch::addr) const;
+
 	private:
-		// TODO: this
 		std::vector<analysis_path> analysis_paths;
+		address_bitmap instructions;
 	};
 
 	class control_flow_context
@@ -55,6 +75,11 @@ namespace chasm::ds
 		void callstack_push(arch::addr proc_entrypoint);
 		void callstack_pop();
 
+		//
+		// To be called once an instruction is added to the analyzed path
+		//
+		void instruction_added();
+
 		[[nodiscard]] bool was_visited(arch::addr address) const;
 		[[nodiscard]] bool inside_procedure() const;
 
@@ -67,7 +92,13 @@ namespace chasm::ds
 		//
 		std::vector<analysis_path> paths;
 
-		std::unordered_set<arch::addr> visited_entrypoints;
+		//
+		// number of paths on the stack outside procedures having an instruction at each address,
+		// past their first one, so popping a path forgets only what no other path decoded
+		//
+		std::vector<uint32_t> paths_instructions;
+
+		address_bitmap visited_entrypoints;
 	};
 }
 
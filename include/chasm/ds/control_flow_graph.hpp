@@ -0,0 +1,139 @@
+#ifndef CHASM_CONTROL_FLOW_GRAPH_HPP
+#define CHASM_CONTROL_FLOW_GRAPH_HPP
+
+
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <chasm/ds/disassembly_graph.hpp>
+#include <chasm/ds/decode_table.hpp>
+#include <chasm/arch.hpp>
+
+
+namespace chasm::ds
+{
+	///
+	/// Basic blocks of the code reached from some roots, without entering called procedures.
+	///
+	/// Blocks are numbered densely in address order. A block is split wherever a jump or a skip lands,
+	/// and every skip has two successors, the next instruction and the one after it. The dominator
+	/// tree is computed with the Cooper-Harvey-Kennedy iteration over the reverse postorder of the
+	/// blocks, then every back edge (to a block dominating its source) gives a natural loop.
+	///
+	class control_flow_graph
+	{
+	public:
+		using block_index = uint32_t;
+
+		struct basic_block
+		{
+			arch::addr start;
+
+			//
+			// address past the last instruction
+			//
+			arch::addr end;
+
+			std::vector<block_index> successors;
+			std::vector<block_index> predecessors;
+		};
+
+		struct natural_loop
+		{
+			block_index header;
+
+			//
+			// header included, sorted
+			//
+			std::vector<block_index> blocks;
+		};
+
+		//
+		// Roots already reached from an earlier root, or not decoding, are left out
+		//
+		control_flow_graph(std::span<const predecoded_opcode> opcodes, arch::addr base, std::span<const arch::addr> roots);
+		~control_flow_graph() = default;
+
+		control_flow_graph(control_flow_graph&&) = default;
+		control_flow_graph(const control_flow_graph&) = default;
+		control_flow_graph& operator=(control_flow_graph&&) = default;
+		control_flow_graph& operator=(const control_flow_graph&) = default;
+
+		[[nodiscard]] std::span<const basic_block> blocks() const&;
+		std::span<const basic_block> blocks() const&& = delete;
+
+		[[nodiscard]] std::span<const block_index> roots() const&;
+		std::span<const block_index> roots() const&& = delete;
+
+		//
+		// Sorted by header
+		//
+		[[nodiscard]] std::span<const natural_loop> loops() const&;
+		std::span<const natural_loop> loops() const&& = delete;
+
+		//
+		// Nothing for the blocks only dominated by the virtual block preceding all the roots: the
+		// roots, and the blocks reached from several roots without going through a common block
+		//
+		[[nodiscard]] std::optional<block_index> immediate_dominator(block_index block) const;
+		[[nodiscard]] bool dominates(block_index dominator, block_index block) const;
+
+		//
+		// Number of loops the block is part of
+		//
+		[[nodiscard]] size_t loop_depth(block_index block) const;
+		[[nodiscard]] bool is_loop_header(block_index block) const;
+
+		//
+		// The block starting at, or containing, the address, if any
+		//
+		[[nodiscard]] std::optional<block_index> block_at(arch::addr start) const;
+		[[nodiscard]] std::optional<block_index> block_containing(arch::addr address) const;
+
+	private:
+		void split_blocks(std::span<const predecoded_opcode> opcodes, arch::addr base, std::span<const arch::addr> roots);
+		void compute_dominators();
+		void find_loops();
+
+	private:
+		std::vector<basic_block> basic_blocks;
+		std::vector<block_index> root_blocks;
+		std::vector<block_index> idoms;
+		std::vector<natural_loop> natural_loops;
+		std::vector<uint32_t> depths;
+	};
+
+	///
+	/// The control-flow graphs of a disassembled binary: the code outside of any procedure, rooted at
+	/// the entry point then at the other paths it does not reach, and each procedure of the graph.
+	///
+	struct program_flow
+	{
+		control_flow_graph entry;
+
+		//
+		// in the order of disassembly_graph::get_procedures
+		//
+		std::vector<control_flow_graph> procedures;
+	};
+
+	//
+	// Built from the opcodes the disassembler of the graph predecoded
+	//
+	[[nodiscard]] program_flow build_program_flow(std::span<const predecoded_opcode> opcodes,
+												  arch::addr base,
+												  arch::addr entry,
+												  const disassembly_graph& graph);
+
+	//
+	// Graphviz document with a cluster per control-flow graph, the edges between blocks, the
+	// immediate dominators as dashed edges, and the loop headers drawn with a double border
+	//
+	[[nodiscard]] std::string export_dot(const program_flow& flow);
+}
+
+
+#endif //CHASM_CONTROL_FLOW_GRAPH_HPP
@@ -0,0 +1,65 @@
+#ifndef CHASM_DECODE_TABLE_HPP
+#define CHASM_DECODE_TABLE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <span>
+
+#include <chasm/arch.hpp>
+
+
+namespace chasm::ds
+{
+	//
+	// How the traversal goes on after an instruction
+	//
+	enum class flow_type : uint8_t
+	{
+		invalid,  // not an instruction
+		next,     // the next instruction follows
+		skip,     // conditional skip, only its fallthrough is followed
+		fork,     // "se rX, NN", both of its outcomes are followed
+		jump,     // goes on at the address operand
+		call,     // enters the procedure at the address operand, then the next instruction follows
+		end       // the path stops, returns and indirect jumps
+	};
+
+	struct opcode_info
+	{
+		uint16_t mask;
+		uint8_t id;
+		flow_type flow;
+
+		[[nodiscard]] constexpr arch::instruction_id instruction() const { return static_cast<arch::instruction_id>(id); }
+		[[nodiscard]] constexpr arch::operands_mask operands() const { return static_cast<arch::operands_mask>(mask); }
+	};
+
+	static_assert(sizeof(opcode_info) == 4);
+
+	//
+	// Every 16-bit opcode mapped to its instruction, generated at compile time. The operands of an
+	// instruction are extracted from its opcode with arch::dec according to its operands mask.
+	//
+	extern const std::array<opcode_info, 0x10000> decode_table;
+
+	[[nodiscard]] inline const opcode_info& decode(arch::opcode opcode)
+	{
+		return decode_table[opcode];
+	}
+
+	struct predecoded_opcode
+	{
+		arch::opcode opcode;
+		opcode_info info;
+	};
+
+	//
+	// Decodes the opcode starting at every offset of a ROM in one sweep, odd offsets included since
+	// jumps can land anywhere. The last byte never starts a whole opcode and is decoded as invalid.
+	//
+	[[nodiscard]] std::vector<predecoded_opcode> predecode(std::span<const uint8_t> bytes);
+}
+
+
+#endif //CHASM_DECODE_TABLE_HPP
@@ -2,21 +2,54 @@
 #define CHASM_DISASSEMBLER_HPP
 
 
+#include <initializer_list>
+#include <string_view>
+#include <optional>
 #include <vector>
 #include <memory>
+#include <span>
 
 #include <chasm/ds/disassembly_graph.hpp>
 #include <chasm/ds/control_flow_context.hpp>
+#include <chasm/ds/decode_table.hpp>
 #include <chasm/chasm_exception.hpp>
 #include <chasm/arch.hpp>
 
 
 namespace chasm::ds
 {
+	enum class disassembly_mode
+	{
+		//
+		// follows the control flow from the entry point, code only reached through indirect jumps is missed
+		//
+		recursive,
+
+		//
+		// decodes the ROM from start to end, data that happens to decode is shown as code
+		//
+		linear,
+
+		//
+		// follows the control flow from the entry point, then from every run of the linear sweep that
+		// looks like code and was not reached yet, the code decoded first winning where they overlap
+		//
+		hybrid
+	};
+
+	[[nodiscard]] std::optional<disassembly_mode> parse_disassembly_mode(std::string_view name);
+
 	class disassembler
 	{
 	public:
-		disassembler(std::vector<uint8_t> from_bytes, arch::addr from_addr);
+		//
+		// With several threads, the procedures are analyzed in parallel once the traversal from the
+		// entry point found their calls, 0 for one thread per hardware thread
+		//
+		disassembler(std::vector<uint8_t> from_bytes,
+					 arch::addr from_addr,
+					 disassembly_mode mode = disassembly_mode::recursive,
+					 unsigned int threads = 1);
 		~disassembler() = default;
 
 		disassembler(disassembler&) = delete;
@@ -24,66 +57,106 @@ namespace chasm::ds
 		disassembler& operator=(disassembler&) = delete;
 		disassembler& operator=(disassembler&&) = delete;
 
-		[[nodiscard]] disassembly_graph get_graph();
+		//
+		// The graph stays owned by the disassembler unless it is moved out of a disassembler about to be destroyed
+		//
+		[[nodiscard]] const disassembly_graph& get_graph() const&;
+		[[nodiscard]] disassembly_graph get_graph() &&;
+
+		//
+		// Every even and odd offset of the binary predecoded, only valid as long as the disassembler is
+		//
+		[[nodiscard]] std::span<const predecoded_opcode> get_opcodes() const&;
+		std::span<const predecoded_opcode> get_opcodes() const&& = delete;
 
 
 	private:
+		//
+		// Analyzes the procedure at the entry point alone, its calls being deferred
+		//
+		disassembler(std::span<const predecoded_opcode> from_opcodes,
+					 arch::addr from_base,
+					 arch::addr procedure_entry,
+					 bool claims);
+
+		//
+		// What is left of the traversal once an instruction branches. The worklist is processed last in,
+		// first out, so paths and procedures are analyzed in the same order a recursive descent would,
+		// while the native stack stays the same size however long the chains of jumps and calls are.
+		//
+		enum class task_type
+		{
+			resume_path,      // decode the current path until it ends or branches again
+			enter_path,       // start a path at the address
+			leave_path,       // record the finished path and go back to the one it branched from
+			enter_procedure,  // start the procedure at the address
+			leave_procedure   // record the finished procedure and go back to its caller
+		};
+
+		struct task
+		{
+			task_type type;
+			arch::addr address = 0;
+		};
+
 		[[nodiscard]] analysis_path& current_path();
+		void ds_recursive(arch::addr from_addr);
+		void ds_parallel(arch::addr from_addr, unsigned int threads);
+		void reset();
+		void ds_linear();
+		void ds_hybrid();
+		void run();
+		void branch(std::initializer_list<task> tasks);
 		void ds_path();
 		void ds_next_instruction();
 
-		template<std::integral ...Args>
-		void emit(arch::instruction_id id, arch::operands_mask mask, Args... args)
+		void emit(const predecoded_opcode& instruction)
 		{
-			current_path().add_instruction(id, mask, args...);
+			if (track_claims)
+				fresh_instructions.push_back(current_path().addr_end());
+
+			current_path().add_instruction(instruction.info.instruction(), instruction.info.operands(), instruction.opcode);
+			flow.instruction_added();
 		}
 
-		void ds_cls();
-		void ds_ret();
-		void ds_scrr();
-		void ds_scrl();
-		void ds_exit();
-		void ds_low();
-		void ds_high();
-		void ds_scrd();
+		//
+		// Seeded traversals do not decode again what an earlier traversal decoded, nor what does not
+		// decode since they may start in data
+		//
+		[[nodiscard]] bool stops_at(arch::addr address) const;
+
 		void ds_call(arch::addr subroutine_addr);
 		void ds_jmp(arch::addr location);
-		void ds_mov_ar_addr(arch::addr addr);
-		void ds_jmp_indirect(arch::addr offset);
-		void ds_se_r8_imm(arch::reg reg, arch::imm imm);
-		void ds_sne_r8_imm(arch::reg reg, arch::imm imm);
-		void ds_mov_r8_imm(arch::reg reg, arch::imm imm);
-		void ds_add_r8_imm(arch::reg reg, arch::imm imm);
-		void ds_rand_r8_imm(arch::reg reg, arch::imm imm);
-		void ds_mov_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_or_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_and_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_xor_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_add_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_sub_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_shl_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_suba_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_shr_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_se_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_sne_r8_r8(arch::reg reg1, arch::reg reg2);
-		void ds_ske_r8(arch::reg reg);
-		void ds_skne_r8(arch::reg reg);
-		void ds_mov_r8_dt(arch::reg);
-		void ds_mov_dt_r8(arch::reg);
-		void ds_mov_st_r8(arch::reg);
-		void ds_add_ar_r8(arch::reg);
-		void ds_ldf_r8(arch::reg);
-		void ds_ldfs_r8(arch::reg);
-		void ds_rdump_r8(arch::reg);
-		void ds_rload_r8(arch::reg);
-		void ds_saverpl_r8(arch::reg);
-		void ds_loadrpl_r8(arch::reg);
-		void ds_draw_r8_r8_imm(arch::reg reg1, arch::reg reg2, arch::imm imm);
+		void ds_fork();
 
 	private:
-		std::vector<uint8_t> binary;
+		std::vector<predecoded_opcode> decoded;
+		std::span<const predecoded_opcode> opcodes;
+		arch::addr base;
 		control_flow_context flow;
 		disassembly_graph ds_graph;
+		std::vector<task> worklist;
+		std::vector<arch::addr> fresh_instructions;
+		address_bitmap claimed_instructions;
+
+		//
+		// only the hybrid mode reads which instructions were decoded, to not traverse them again
+		//
+		bool track_claims = false;
+
+		//
+		// seeded traversals may start in data, where they stop instead of failing
+		//
+		bool speculative = false;
+
+		//
+		// Parallel analyses only record the calls they find, and the paths they start so the
+		// analyses can be checked not to share any, which the serial traversal would have decoded
+		// only once
+		//
+		bool defer_calls = false;
+		std::vector<arch::addr> deferred_calls;
+		std::vector<arch::addr> path_starts;
 	};
 
 	namespace disassembly_exception
@@ -2,7 +2,8 @@
 #define CHASM_DISASSEMBLY_GRAPH_HPP
 
 
-#include <set>
+#include <vector>
+#include <span>
 
 #include <chasm/arch.hpp>
 #include <chasm/ds/paths.hpp>
@@ -10,6 +11,14 @@
 
 namespace chasm::ds
 {
+	///
+	/// Procedures and paths outside of any procedure, each kept in a vector sorted by address, so they
+	/// are iterated contiguously and looked up by binary search. An index into the views stays valid
+	/// once the graph is built.
+	///
+	/// While the graph is built, procedures and paths are appended in the order they are found, then
+	/// sorted once when it is finalized. Inserts made after that keep the vectors sorted.
+	///
 	class disassembly_graph
 	{
 	public:
@@ -21,18 +30,40 @@ namespace chasm::ds
 		disassembly_graph& operator=(const disassembly_graph&) = default;
 		disassembly_graph& operator=(disassembly_graph&&) = default;
 
+		//
+		// Appended while the graph is built, then sorted by finalize which leaves out a procedure or
+		// a path at an address appended before
+		//
+		void append_proc(procedure);
+		void append_path(path);
+
+		//
+		// Appends the procedures and paths of the other graph to this one
+		//
+		void merge(disassembly_graph&& other);
+
+		void finalize();
+
+		//
+		// Inserts into a finalized graph, a procedure or a path at an address already in the graph is left out
+		//
 		void insert_proc(procedure);
 		void insert_path(path);
 
-		[[nodiscard]] std::set<procedure> get_procedures() const;
-		[[nodiscard]] std::set<path> get_paths() const;
-
-	private:
 		//
-		// sorted by entrypoint address
+		// Views sorted by address, only valid as long as the graph is
 		//
-		std::set<procedure> procedures;
-		std::set<path> paths;
+		[[nodiscard]] std::span<const procedure> get_procedures() const&;
+		[[nodiscard]] std::span<const path> get_paths() const&;
+		std::span<const procedure> get_procedures() const&& = delete;
+		std::span<const path> get_paths() const&& = delete;
+
+		[[nodiscard]] const procedure* find_procedure(arch::addr entrypoint) const;
+		[[nodiscard]] const path* find_path(arch::addr start) const;
+
+	private:
+		std::vector<procedure> procedures;
+		std::vector<path> paths;
 	};
 }
 
@@ -2,9 +2,11 @@
 #define CHASM_DISASSEMBLY_INTERFACE_HPP
 
 
+#include <optional>
 #include <vector>
 #include <memory>
 
+#include <chasm/ds/control_flow_graph.hpp>
 #include <chasm/ds/disassembly_graph.hpp>
 #include <chasm/ds/paths.hpp>
 
@@ -14,7 +16,10 @@ namespace chasm::ds
 	class disassembly_interface
 	{
 	public:
-		explicit disassembly_interface(disassembly_graph&& graph_);
+		//
+		// With the control flow of the graph, the listing shows its basic blocks
+		//
+		explicit disassembly_interface(disassembly_graph&& graph_, std::optional<program_flow> flow_ = std::nullopt);
 
 		disassembly_interface(const disassembly_interface&) = delete;
 		disassembly_interface(disassembly_interface&&) = delete;
@@ -24,12 +29,11 @@ namespace chasm::ds
 		~disassembly_interface() = default;
 
 		void run();
-
-	private:
 		void print_disassembly() const;
 
 	private:
 		disassembly_graph graph;
+		std::optional<program_flow> flow;
 
 		bool is_running = true;
 	};
@@ -1,6 +1,7 @@
 #ifndef CHASM_FORMATTER_HPP
 #define CHASM_FORMATTER_HPP
 
+#include <iterator>
 #include <format>
 #include <string>
 
@@ -17,33 +18,48 @@ namespace chasm::ds::formatter
 #define F_DT "dt"
 #define F_ST "st"
 
-	template<std::integral ...Args>
-	std::string format(arch::instruction_id id, arch::operands_mask mask, Args...args)
+	//
+	// The operands are taken back from the opcode they were decoded from, each operands mask has its
+	// own format string so the formats are checked at compile time and nothing is parsed at runtime.
+	//
+	template<std::output_iterator<char> OutputIt>
+	OutputIt format_to(OutputIt out, arch::instruction_id id, arch::operands_mask mask, arch::opcode opcode)
 	{
-		const auto s = [=]() -> std::string
+		const auto mnemonic = arch::mnemonics[id];
+
+		const auto x = arch::dec::X(opcode);
+		const auto y = arch::dec::Y(opcode);
+		const auto n = arch::dec::N(opcode);
+		const auto nn = arch::dec::NN(opcode);
+		const auto nnn = arch::dec::NNN(opcode);
+
+		switch (mask)
 		{
-			switch (mask)
-			{
-				case arch::MASK_R8_R8: return F_R8 ", " F_R8;
-				case arch::MASK_R8_IMM: return F_R8 ", " F_IMM;
-				case arch::MASK_R8: return F_R8;
-				case arch::MASK_AR_R8: return F_AR ", " F_R8;
-				case arch::MASK_AR_IMM: return F_AR ", " F_IMM;
-				case arch::MASK_AR_ADDR: return F_AR ", " F_ADDR;
-				case arch::MASK_DT_R8: return F_DT ", " F_R8;
-				case arch::MASK_ST_R8: return F_ST ", " F_R8;
-				case arch::MASK_R8_DT: return F_R8 ", " F_DT;
-				case arch::MASK_IMM: return F_IMM;
-				case arch::MASK_ADDR: return F_ADDR;
-				case arch::MASK_ADDR_REL: return F_ADDR_REL;
-				case arch::MASK_R8_R8_IMM: return F_R8 ", " F_R8 ", " F_IMM;
-
-				default:
-					return {};
-			}
-		}();
-
-		return std::vformat("{} " + s, std::make_format_args(arch::mnemonics[id], args...));
+			case arch::MASK_R8_R8: return std::format_to(out, "{} " F_R8 ", " F_R8, mnemonic, x, y);
+			case arch::MASK_R8_IMM: return std::format_to(out, "{} " F_R8 ", " F_IMM, mnemonic, x, nn);
+			case arch::MASK_R8: return std::format_to(out, "{} " F_R8, mnemonic, x);
+			case arch::MASK_AR_R8: return std::format_to(out, "{} " F_AR ", " F_R8, mnemonic, x);
+			case arch::MASK_AR_IMM: return std::format_to(out, "{} " F_AR ", " F_IMM, mnemonic, nnn);
+			case arch::MASK_AR_ADDR: return std::format_to(out, "{} " F_AR ", " F_ADDR, mnemonic, nnn);
+			case arch::MASK_DT_R8: return std::format_to(out, "{} " F_DT ", " F_R8, mnemonic, x);
+			case arch::MASK_ST_R8: return std::format_to(out, "{} " F_ST ", " F_R8, mnemonic, x);
+			case arch::MASK_R8_DT: return std::format_to(out, "{} " F_R8 ", " F_DT, mnemonic, x);
+			case arch::MASK_IMM: return std::format_to(out, "{} " F_IMM, mnemonic, n);
+			case arch::MASK_ADDR: return std::format_to(out, "{} " F_ADDR, mnemonic, nnn);
+			case arch::MASK_ADDR_REL: return std::format_to(out, "{} " F_ADDR_REL, mnemonic, nnn);
+			case arch::MASK_R8_R8_IMM: return std::format_to(out, "{} " F_R8 ", " F_R8 ", " F_IMM, mnemonic, x, y, n);
+
+			default:
+				return std::format_to(out, "{} ", mnemonic);
+		}
+	}
+
+	inline std::string format(arch::instruction_id id, arch::operands_mask mask, arch::opcode opcode)
+	{
+		std::string text;
+		format_to(std::back_inserter(text), id, mask, opcode);
+
+		return text;
 	}
 }
 
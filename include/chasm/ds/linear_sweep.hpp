@@ -0,0 +1,37 @@
+#ifndef CHASM_LINEAR_SWEEP_HPP
+#define CHASM_LINEAR_SWEEP_HPP
+
+#include <cstdint>
+#include <vector>
+#include <span>
+
+#include <chasm/ds/decode_table.hpp>
+
+
+namespace chasm::ds
+{
+	struct code_run
+	{
+		//
+		// file offset of the first instruction
+		//
+		size_t offset;
+		size_t instructions;
+
+		//
+		// the run ends with a jump, a return or an exit instead of running into bytes that do not
+		// decode or into the end of the ROM, so it is plausible code rather than data
+		//
+		bool terminated;
+	};
+
+	//
+	// Splits the even offsets of a pre-decoded ROM into runs of decodable opcodes, each run ending
+	// after a jump, a return or an exit, or before an opcode that does not decode. The opcodes are
+	// classified 64 at a time into bitmasks, so long runs are skipped a word at a time.
+	//
+	[[nodiscard]] std::vector<code_run> linear_sweep(std::span<const predecoded_opcode> decoded);
+}
+
+
+#endif //CHASM_LINEAR_SWEEP_HPP
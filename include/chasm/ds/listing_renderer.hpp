@@ -0,0 +1,23 @@
+#ifndef CHASM_LISTING_RENDERER_HPP
+#define CHASM_LISTING_RENDERER_HPP
+
+
+#include <string>
+
+#include <chasm/ds/control_flow_graph.hpp>
+#include <chasm/ds/disassembly_graph.hpp>
+
+
+namespace chasm::ds
+{
+	//
+	// Renders the listing of the procedures then the paths of the graph, as shown by the disassembly
+	// interface, into a single buffer sized from the number of instructions up front, so it can be
+	// written out at once. Given the control flow of the graph, a comment line shows where each basic
+	// block starts, its predecessors, immediate dominator and loops.
+	//
+	[[nodiscard]] std::string render_listing(const disassembly_graph& graph, const program_flow* flow = nullptr);
+}
+
+
+#endif //CHASM_LISTING_RENDERER_HPP
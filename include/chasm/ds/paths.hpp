@@ -1,9 +1,11 @@
 #ifndef CHASM_PATHS_HPP
 #define CHASM_PATHS_HPP
 
+#include <functional>
+#include <algorithm>
 #include <string>
 #include <vector>
-#include <set>
+#include <span>
 
 #include <chasm/arch.hpp>
 #include <chasm/ds/formatter.hpp>
@@ -11,6 +13,18 @@
 
 namespace chasm::ds
 {
+	//
+	// Instructions are kept as decoded, their text is only rendered when they are printed
+	//
+	struct decoded_instruction
+	{
+		arch::opcode opcode;
+		uint16_t mask;
+		uint8_t id;
+	};
+
+	static_assert(sizeof(decoded_instruction) <= 8);
+
 	class path
 	{
 	public:
@@ -24,40 +38,105 @@ namespace chasm::ds
 
 		bool operator<(const path& other) const;
 
-		template<std::integral ...Args>
-		void add_instruction(arch::instruction_id id, arch::operands_mask mask, Args...args)
-		{
-			disassembly.emplace_back(
-						ds::formatter::format(id, mask, args...)
-					);
-		}
+		void add_instruction(arch::instruction_id id, arch::operands_mask mask, arch::opcode opcode);
 
 		[[nodiscard]] arch::addr addr_start() const;
 		[[nodiscard]] arch::addr addr_end() const;
 		[[nodiscard]] size_t instructions_count() const;
+		[[nodiscard]] const decoded_instruction& instruction(size_t instruction_index) const;
 		[[nodiscard]] std::string symbolic(size_t instruction_index) const;
 
+		template<std::output_iterator<char> OutputIt>
+		OutputIt symbolic_to(OutputIt out, size_t instruction_index) const
+		{
+			const auto& [opcode, mask, id] = disassembly[instruction_index];
+
+			return ds::formatter::format_to(out,
+											static_cast<arch::instruction_id>(id),
+											static_cast<arch::operands_mask>(mask),
+											opcode);
+		}
+
 	private:
 		arch::addr start_addr;
-		std::vector<std::string> disassembly;
+		std::vector<decoded_instruction> disassembly;
 	};
 
 	class procedure
 	{
 	public:
 		explicit procedure(arch::addr ep);
+
+		//
+		// The paths may come in any order, the first one at each address is kept
+		//
+		procedure(arch::addr ep, std::vector<path>&& paths);
 		virtual ~procedure() = default;
 
+		procedure(procedure&&) = default;
+		procedure(const procedure&) = default;
+		procedure& operator=(procedure&&) = default;
+		procedure& operator=(const procedure&) = default;
+
 		bool operator<(const procedure& other) const;
 
 		[[nodiscard]] arch::addr entrypoint() const;
-		[[nodiscard]] std::set<path> get_paths() const;
+
+		//
+		// Sorted by start address, the view is only valid as long as the procedure is
+		//
+		[[nodiscard]] std::span<const path> get_paths() const&;
+		std::span<const path> get_paths() const&& = delete;
+
+		//
+		// The path starting at the address, if any
+		//
+		[[nodiscard]] const path* find_path(arch::addr start) const;
+
 		void insert_path(path p);
 
 	private:
 		arch::addr ep;
-		std::set<path> ordered_paths;
+		std::vector<path> ordered_paths;
 	};
+
+	//
+	// Inserts the element into a vector kept sorted on its address, unless an element already has
+	// the same address, in which case the first one is kept as a set would do
+	//
+	template<typename T, typename Address>
+	bool insert_sorted(std::vector<T>& sorted, T element, Address address)
+	{
+		const auto key = std::invoke(address, element);
+		const auto at = std::ranges::lower_bound(sorted, key, {}, address);
+
+		if (at != sorted.end() && std::invoke(address, *at) == key)
+			return false;
+
+		sorted.insert(at, std::move(element));
+		return true;
+	}
+
+	//
+	// Sorts elements appended in any order on their address, keeping the first one appended at each
+	// address as insert_sorted would, in O(n log n) for a whole graph instead of O(n^2) inserts
+	//
+	template<typename T, typename Address>
+	void sort_unique(std::vector<T>& elements, Address address)
+	{
+		std::ranges::stable_sort(elements, {}, address);
+
+		const auto duplicates = std::ranges::unique(elements, {}, address);
+		elements.erase(duplicates.begin(), duplicates.end());
+	}
+
+	template<typename T, typename Address>
+	const T* find_sorted(const std::vector<T>& sorted, arch::addr key, Address address)
+	{
+		const auto at = std::ranges::lower_bound(sorted, key, {}, address);
+
+		return at != sorted.end() && std::invoke(address, *at) == key ? &*at : nullptr;
+	}
 }
 
 #endif //CHASM_PATHS_HPP
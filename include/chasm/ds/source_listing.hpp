@@ -0,0 +1,26 @@
+#ifndef CHASM_SOURCE_LISTING_HPP
+#define CHASM_SOURCE_LISTING_HPP
+
+
+#include <cstdint>
+#include <string>
+#include <span>
+
+#include <chasm/ds/disassembly_graph.hpp>
+#include <chasm/arch.hpp>
+
+
+namespace chasm::ds
+{
+	//
+	// Renders the ROM loaded at base as a chasm source assembling back to the same bytes with the
+	// same --relocate. Bytes are written in ROM order, the decoded instructions as instructions and
+	// every other byte as raw data, all under top-level labels so any of them can be jumped to.
+	// Jumps whose target starts an instruction or a byte of data go to a label, calls and the other
+	// jumps are kept as raw opcodes since procedures would be moved after the labels when assembled.
+	//
+	[[nodiscard]] std::string render_source(std::span<const uint8_t> rom, arch::addr base, const disassembly_graph& graph);
+}
+
+
+#endif //CHASM_SOURCE_LISTING_HPP
@@ -0,0 +1,68 @@
+#ifndef CHASM_FILE_IO_HPP
+#define CHASM_FILE_IO_HPP
+
+
+#include <filesystem>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+
+namespace chasm
+{
+	///
+	/// Read-only view of a whole file, memory mapped where the platform allows it
+	///
+	class mapped_file
+	{
+	public:
+		~mapped_file();
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file(mapped_file&& other) noexcept;
+		mapped_file& operator=(const mapped_file&) = delete;
+		mapped_file& operator=(mapped_file&&) = delete;
+
+		//
+		// Returns nothing when the file cannot be opened
+		//
+		[[nodiscard]] static std::optional<mapped_file> open(const std::filesystem::path& path);
+
+		[[nodiscard]] std::span<const uint8_t> bytes() const;
+
+	private:
+		mapped_file() = default;
+
+	private:
+		const uint8_t* address = nullptr;
+		size_t size = 0;
+
+		//
+		// used instead of a mapping for empty files and platforms without mmap
+		//
+		std::vector<uint8_t> fallback;
+	};
+
+	//
+	// Writes to a temporary file renamed over the destination, so readers
+	// (possibly mapping the file) never see a partially written file
+	//
+	void write_atomic(const std::filesystem::path& path, std::span<const char> data);
+
+	//
+	// "-" given as a file path designates the standard input or output
+	//
+	[[nodiscard]] bool is_stdio(const std::filesystem::path& path);
+
+	//
+	// Binary-safe reads and writes of the standard streams, read in chunks straight into the result
+	//
+	[[nodiscard]] std::string read_stdin();
+	[[nodiscard]] std::vector<uint8_t> read_stdin_bytes();
+	void write_stdout(std::span<const char> data);
+}
+
+
+#endif //CHASM_FILE_IO_HPP
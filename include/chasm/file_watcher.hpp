@@ -0,0 +1,44 @@
+#ifndef CHASM_FILE_WATCHER_HPP
+#define CHASM_FILE_WATCHER_HPP
+
+
+#include <filesystem>
+#include <chrono>
+
+
+namespace chasm
+{
+	///
+	/// Blocks until a file is written to, backed by inotify.
+	///
+	/// The parent directory is watched rather than the file itself, as most editors
+	/// save by writing a temporary file renamed over the original one.
+	///
+	class file_watcher
+	{
+	public:
+		explicit file_watcher(const std::filesystem::path& file);
+		~file_watcher();
+
+		file_watcher(const file_watcher&) = delete;
+		file_watcher(file_watcher&&) = delete;
+		file_watcher& operator=(const file_watcher&) = delete;
+		file_watcher& operator=(file_watcher&&) = delete;
+
+		//
+		// Returns once the file changed and no other change happened for the debounce duration,
+		// so a burst of writes from an editor only triggers one rebuild
+		//
+		void wait_for_change(std::chrono::milliseconds debounce);
+
+	private:
+		[[nodiscard]] bool read_events(int timeout_ms);
+
+	private:
+		std::filesystem::path filename;
+		int inotify_fd = -1;
+	};
+}
+
+
+#endif //CHASM_FILE_WATCHER_HPP
@@ -2,8 +2,13 @@
 #define CHASM_GENERATOR_HPP
 
 #include <unordered_map>
+#include <filesystem>
+#include <concepts>
 
 #include <chasm/chasm_exception.hpp>
+#include <chasm/object_file.hpp>
+#include <chasm/symbol_file.hpp>
+#include <chasm/incremental.hpp>
 #include <chasm/ast_visitor.hpp>
 #include <chasm/config.hpp>
 #include <chasm/arch.hpp>
@@ -16,6 +21,7 @@ namespace chasm
 	{
 	public:
 		generator() = default;
+		explicit generator(incremental_state& state);
 		generator(const generator&) = delete;
 		generator(generator&&) = delete;
 		generator& operator=(const generator&) = delete;
@@ -23,6 +29,18 @@ namespace chasm
 		~generator() = default;
 
 		[[nodiscard]] std::vector<uint8_t> generate(const ast::abstract_tree&);
+		[[nodiscard]] object_file generate_object(const ast::abstract_tree&);
+
+		//
+		// Lays out the sprites and applies the address patches once every statement
+		// was visited, when they are not generated from a tree
+		//
+		[[nodiscard]] std::vector<uint8_t> finalize();
+
+		//
+		// Source line of every instruction generated so far, by offset in the binary
+		//
+		[[nodiscard]] const std::vector<source_line>& source_lines() const;
 
 		void visit(const ast::procedure_statement&) override;
 		void visit(const ast::instruction_statement&) override;
@@ -40,7 +58,24 @@ namespace chasm
 		void register_constant(std::string&& symbol, arch::imm value);
 		void register_sprite(std::string&& symbol, const arch::sprite& sprite);
 		void register_symbol_addr(std::string symbol);
+		void register_symbol_addr(std::string symbol, arch::addr address);
 		void register_patch_location(std::string&& symbol);
+		void record_line(size_t line);
+
+		//
+		// Top-level procedures and labels go through here so they can be reused by incremental builds
+		//
+		template<std::invocable Encoder>
+		void encode_block(const ast::base_statement& block, size_t line, Encoder&& encode);
+		void replay_block(const ast::base_statement& block, const incremental_state::block& cached, size_t line);
+
+		//
+		// Warns about the instruction unless the "super" flag is given, and keeps it in the recorded block
+		//
+		void super_instruction(const ast::instruction_statement& instruction);
+
+		template<typename... Args>
+		void update_environment(Args&&... args);
 
 		[[nodiscard]] arch::opcode encode_add(const ast::instruction_statement&);
 		[[nodiscard]] arch::opcode encode_sub(const ast::instruction_statement&);
@@ -81,6 +116,7 @@ namespace chasm
 		[[nodiscard]] std::vector<arch::opcode> encode_swp(const ast::instruction_statement&);
 
 		void post_visit();
+		void layout_sprites();
 
 		[[nodiscard]] arch::imm operand2imm(const token& token,
 											arch::imm_format imm_width = arch::imm_format::fmt_imm8) const;
@@ -98,13 +134,31 @@ namespace chasm
 
 		std::vector<uint8_t> binary;
 		std::vector<address_patch> patches;
+		std::vector<source_line> lines;
 		std::unordered_map<std::string, arch::addr> sym_addresses;
 		std::unordered_map<std::string, arch::imm> constants;
 		std::unordered_map<std::string, arch::sprite> sprites;
+
+		//
+		// sprites are laid out in declaration order, not in the hash order of the map,
+		// so the binary is the same whatever the standard library
+		//
+		std::vector<std::string> sprite_order;
 		config cfg;
 
 		std::string current_proc_name;
 
+		incremental_state* incremental = nullptr;
+		incremental_state::block* recording = nullptr;
+		size_t recording_start = 0;
+		size_t recording_line = 0;
+		uint32_t recording_instructions = 0;
+
+		//
+		// hash of the constants, sprites and configs declared so far
+		//
+		hasher::value_type environment {};
+
 		typedef arch::opcode(generator::*encoder)(const ast::instruction_statement&);
 		typedef std::vector<arch::opcode>(generator::*pseudo_encoder)(const ast::instruction_statement&);
 
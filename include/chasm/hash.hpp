@@ -0,0 +1,64 @@
+#ifndef CHASM_HASH_HPP
+#define CHASM_HASH_HPP
+
+
+#include <string_view>
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+
+namespace chasm
+{
+	//
+	// 64-bit FNV-1a, cheap enough to fingerprint whole sources on every build
+	// and stable across platforms/standard libraries, unlike std::hash
+	//
+	class hasher
+	{
+	public:
+		using value_type = uint64_t;
+
+		hasher& update(std::span<const uint8_t> bytes)
+		{
+			for (const auto b : bytes)
+			{
+				state ^= b;
+				state *= PRIME;
+			}
+
+			return *this;
+		}
+
+		hasher& update(std::string_view str)
+		{
+			return update(std::span(reinterpret_cast<const uint8_t*>(str.data()), str.size()));
+		}
+
+		template<std::integral T>
+		hasher& update(T value)
+		{
+			for (size_t i = 0; i < sizeof(T); ++i)
+			{
+				state ^= static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8));
+				state *= PRIME;
+			}
+
+			return *this;
+		}
+
+		[[nodiscard]] value_type digest() const
+		{
+			return state;
+		}
+
+	private:
+		static constexpr value_type OFFSET_BASIS = 0xcbf29ce484222325;
+		static constexpr value_type PRIME        = 0x00000100000001b3;
+
+		value_type state = OFFSET_BASIS;
+	};
+}
+
+
+#endif //CHASM_HASH_HPP
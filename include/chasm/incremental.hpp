@@ -0,0 +1,104 @@
+#ifndef CHASM_INCREMENTAL_HPP
+#define CHASM_INCREMENTAL_HPP
+
+
+#include <unordered_map>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <chasm/statements.hpp>
+#include <chasm/hash.hpp>
+#include <chasm/arch.hpp>
+
+
+namespace chasm
+{
+	///
+	/// Encoded top-level blocks (procedures and labels) kept from one generation to the next.
+	///
+	/// A block is keyed by a fingerprint of its statements, source locations excluded, mixed with
+	/// the generator state it was encoded in (constants, sprites, configs declared so far).
+	/// Its code is stored before address patching, so a reused block is only re-patched
+	/// when the addresses it references moved.
+	///
+	class incremental_state
+	{
+	public:
+		using key_type = hasher::value_type;
+
+		struct relative_symbol
+		{
+			std::string name;
+			arch::size_type offset;
+		};
+
+		//
+		// source line relative to the line the block starts at, which moves when lines are inserted above
+		//
+		struct relative_line
+		{
+			arch::size_type offset;
+			uint32_t line_delta;
+		};
+
+		struct block
+		{
+			std::vector<uint8_t> code;
+			std::vector<relative_symbol> symbols;
+			std::vector<relative_symbol> patches;
+			std::vector<relative_line> lines;
+			std::vector<std::pair<std::string, arch::imm>> constants;
+			std::vector<std::pair<std::string, int>> configs;
+			key_type exit_environment {};
+
+			//
+			// SuperCHIP-8 instructions of the block, counted in statement order, so their
+			// warnings are given again when it is reused
+			//
+			std::vector<uint32_t> super_instructions;
+		};
+
+		incremental_state() = default;
+		~incremental_state() = default;
+
+		incremental_state(const incremental_state&) = delete;
+		incremental_state(incremental_state&&) = default;
+		incremental_state& operator=(const incremental_state&) = delete;
+		incremental_state& operator=(incremental_state&&) = default;
+
+		[[nodiscard]] static key_type fingerprint(const ast::base_statement& statement, key_type environment);
+
+		//
+		// Generations are bracketed by begin/commit, blocks that were not part of
+		// the last committed generation are dropped
+		//
+		void begin();
+		void commit();
+
+		[[nodiscard]] std::shared_ptr<const block> reuse(key_type key);
+		void insert(key_type key, block&& encoded);
+
+		//
+		// statistics of the last generation
+		//
+		[[nodiscard]] size_t reused_count() const;
+		[[nodiscard]] size_t encoded_count() const;
+
+		[[nodiscard]] static incremental_state load(const std::filesystem::path& path);
+		void save(const std::filesystem::path& path) const;
+
+	private:
+		using block_map = std::unordered_map<key_type, std::shared_ptr<const block>>;
+
+		block_map previous;
+		block_map current;
+
+		size_t reused = 0;
+		size_t encoded = 0;
+	};
+}
+
+
+#endif //CHASM_INCREMENTAL_HPP
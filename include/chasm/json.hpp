@@ -0,0 +1,37 @@
+#ifndef CHASM_JSON_HPP
+#define CHASM_JSON_HPP
+
+
+#include <string_view>
+#include <iterator>
+#include <format>
+#include <string>
+
+
+namespace chasm::json
+{
+	//
+	// Content of a JSON string literal for the given text, quotes not included
+	//
+	inline std::string escaped(std::string_view str)
+	{
+		std::string result;
+		result.reserve(str.size());
+
+		for (const char c : str)
+		{
+			if (c == '"' || c == '\\')
+				result += '\\';
+
+			if (static_cast<unsigned char>(c) < 0x20)
+				std::format_to(std::back_inserter(result), "\\u{:04x}", static_cast<int>(c));
+			else
+				result += c;
+		}
+
+		return result;
+	}
+}
+
+
+#endif //CHASM_JSON_HPP
@@ -4,6 +4,7 @@
 
 #include <string_view>
 #include <exception>
+#include <concepts>
 #include <variant>
 #include <memory>
 #include <vector>
@@ -50,13 +51,28 @@ namespace chasm
     {
         token_type type;
 		source_location source_location;
-		std::variant<uint16_t, std::string> data;
+
+		//
+		// tokens of a tree loaded from its cache file view their text in the file, which the tree keeps alive
+		//
+		std::variant<uint16_t, std::string, std::string_view> data;
 
 		[[nodiscard]] std::string to_string() const
 		{
 			if (std::holds_alternative<uint16_t>(data))
 				return std::to_string(std::get<uint16_t>(data));
 
+			return std::string(text());
+		}
+
+		//
+		// The text of a non numerical token
+		//
+		[[nodiscard]] std::string_view text() const
+		{
+			if (std::holds_alternative<std::string_view>(data))
+				return std::get<std::string_view>(data);
+
 			return std::get<std::string>(data);
 		}
 
@@ -81,6 +97,18 @@ namespace chasm
 
 		[[nodiscard]] std::vector<token> enumerate_tokens();
 
+		//
+		// Hands the tokens one at a time to the sink, stops early when the sink returns false
+		//
+		template<typename Sink>
+			requires std::predicate<Sink&, token&&>
+		void enumerate_tokens(Sink&& sink)
+		{
+			for (auto t = next_token(); t.type != token_type::eof; t = next_token())
+				if (!sink(std::move(t)))
+					return;
+		}
+
     private:
 		[[nodiscard]] token next_token();
 
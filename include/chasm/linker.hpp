@@ -0,0 +1,56 @@
+#ifndef CHASM_LINKER_HPP
+#define CHASM_LINKER_HPP
+
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+#include <chasm/object_file.hpp>
+#include <chasm/arch.hpp>
+
+
+namespace chasm
+{
+	///
+	/// Combines object files into a ROM.
+	///
+	/// The object defining the ".main" entry point is placed first, the others follow in the
+	/// order they were added, each starting on an opcode boundary. Relocations resolve to the
+	/// local labels of their own object first, then to the symbols exported by any object.
+	///
+	class linker
+	{
+	public:
+		linker() = default;
+		linker(const linker&) = delete;
+		linker(linker&&) = delete;
+		linker& operator=(const linker&) = delete;
+		linker& operator=(linker&&) = delete;
+		~linker() = default;
+
+		void add(object_file&& object, std::string name);
+
+		[[nodiscard]] std::vector<uint8_t> link(arch::addr base_address);
+
+		//
+		// Symbols of the last linked ROM, top-level labels and sprites of the objects other
+		// than the entry one are prefixed with the object name as they may collide
+		//
+		[[nodiscard]] const std::unordered_map<std::string, arch::addr>& symbols() const;
+
+	private:
+		struct input
+		{
+			object_file object;
+			std::string name;
+			arch::addr base = 0;
+		};
+
+		std::vector<input> inputs;
+		std::unordered_map<std::string, arch::addr> linked_symbols;
+	};
+}
+
+
+#endif //CHASM_LINKER_HPP
@@ -7,24 +7,39 @@
 #include <string_view>
 
 
+//
+// Each message is written with a single call so messages from modules
+// assembled in parallel do not interleave
+//
 namespace chasm::log
 {
+    //
+    // Set when the standard output carries an assembled binary or a symbols file,
+    // informational messages then go to the standard error instead
+    //
+    inline bool use_stderr = false;
+
+    inline std::ostream& stream()
+    {
+        return use_stderr ? std::cerr : std::cout;
+    }
+
     template<typename ...Args>
     void info(std::string_view fmt, Args&& ... args)
     {
-        std::cout << "[INFO] " << std::vformat(fmt, std::make_format_args(args...)) << '\n';
+        stream() << std::format("[INFO] {}\n", std::vformat(fmt, std::make_format_args(args...)));
     }
 
     template<typename ...Args>
     void warn(std::string_view fmt, Args&& ... args)
     {
-        std::cout << "[WARN] " << std::vformat(fmt, std::make_format_args(args...)) << '\n';
+        stream() << std::format("[WARN] {}\n", std::vformat(fmt, std::make_format_args(args...)));
     }
 
     template<typename ...Args>
     void error(std::string_view fmt, Args&& ... args)
     {
-        std::cerr << "[ERROR] " << std::vformat(fmt, std::make_format_args(args...)) << '\n';
+        std::cerr << std::format("[ERROR] {}\n", std::vformat(fmt, std::make_format_args(args...)));
     }
 }
 
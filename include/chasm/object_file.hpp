@@ -0,0 +1,61 @@
+#ifndef CHASM_OBJECT_FILE_HPP
+#define CHASM_OBJECT_FILE_HPP
+
+
+#include <string_view>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <chasm/arch.hpp>
+
+
+namespace chasm
+{
+	///
+	/// Relocatable output of a single source file (.c8o), combined into a ROM by the linker.
+	///
+	/// Symbol offsets and relocation locations are relative to the start of the object code.
+	/// Local symbols are the labels (named "proc.label", or ".label" at the top level) and the sprites,
+	/// exports are the procedures.
+	///
+	struct object_file
+	{
+		struct symbol
+		{
+			std::string name;
+			arch::size_type offset;
+		};
+
+		struct relocation
+		{
+			arch::size_type location;
+			std::string symbol;
+		};
+
+		std::vector<uint8_t> code;
+		std::vector<symbol> exports;
+		std::vector<symbol> locals;
+		std::vector<std::string> imports;
+		std::vector<relocation> relocations;
+
+		[[nodiscard]] static bool is_local(std::string_view symbol)
+		{
+			return symbol.contains('.');
+		}
+
+		[[nodiscard]] bool defines_entry_point() const;
+
+		[[nodiscard]] std::vector<uint8_t> serialize() const;
+		[[nodiscard]] static object_file deserialize(std::span<const uint8_t> bytes);
+	};
+
+	//
+	// Writes the 12 bits address of a jmp/call/mov patch, relocated to the memory address the program is loaded at
+	//
+	void apply_relocation(std::span<uint8_t> code, size_t location, std::string_view symbol, uintptr_t address);
+}
+
+
+#endif //CHASM_OBJECT_FILE_HPP
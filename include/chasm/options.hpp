@@ -6,6 +6,7 @@
 #include <string>
 
 #include <chasm/cxxopts.hpp>
+#include <chasm/arch.hpp>
 
 
 namespace chasm
@@ -19,12 +20,36 @@ namespace chasm
 					("h,help", "Show help message")
 					("in", "chasm source file to assemble", cxxopts::value<std::string>())
 					("out", "The generated machine code output file path", cxxopts::value<std::string>()->default_value("out.c8c"))
+					("format", "Formats of the output, among raw, ihex, c, base64 and hexdump. The first one is written to the output file, the others next to it with their own extension", cxxopts::value<std::vector<std::string>>()->default_value("raw"))
 					("dis", "Disassemble the given assembled file", cxxopts::value<std::string>())
+					("dis-mode", "How the disassembler finds code: recursive from the entry point, linear from start to end, or hybrid (recursive, then from whatever the linear sweep finds that looks like code)", cxxopts::value<std::string>()->default_value("recursive"))
+					("dis-threads", "Threads analyzing the procedures of the disassembled binary in parallel, 0 for one per hardware thread", cxxopts::value<unsigned int>()->default_value("1"))
+					("dis-out", "Write the listing of --dis to the given file, - for the standard output, instead of entering the disassembly interface", cxxopts::value<std::string>())
+					("dis-cfg", "Show the basic blocks of the disassembled binary in its listing, with their predecessors, immediate dominator and loops")
+					("dis-dot", "Export the control-flow graphs of the disassembled binary, with their dominators and loops, to the given Graphviz file", cxxopts::value<std::string>())
+					("dis-batch", "Disassemble the ROMs of the given directories, patterns (e.g. roms/*.ch8) and files to chasm sources, without the disassembly interface", cxxopts::value<std::vector<std::string>>())
+					("dis-out-dir", "Directory where --dis-batch writes the sources, next to each ROM when not given", cxxopts::value<std::string>())
+					("dis-report", "File where --dis-batch writes the result of every ROM, one tab separated line each", cxxopts::value<std::string>())
 					("pad-sprites", "Pad odd sized sprites")
 					("hex", "Hexdumps the generated machine code, argument is the amount of opcodes per line", cxxopts::value<unsigned int>()->implicit_value("4"))
 					("symbols", "Generate a file with symbols location in memory/machine code", cxxopts::value<std::string>()->implicit_value("out.c8s"))
+					("symbols-format", "Format of the symbols file, text or binary (sorted tables with source lines, for tools to search in place)", cxxopts::value<std::string>()->default_value("text"))
 					("relocate", "Address in which the binary is supposed to be loaded", cxxopts::value<chasm::arch::addr>()->default_value("0x200"))
-					("super", "Specify the target ISA to be the SUPER-CHIP and removes warning when using non CHIP-8 instructions");
+					("object", "Assemble the input file into a relocatable object file to be linked with other objects")
+					("link", "Link the given object files into a binary, the object defining \".main\" comes first", cxxopts::value<std::vector<std::string>>())
+					("project", "Build the modules of the given project manifest and link them", cxxopts::value<std::string>())
+					("jobs", "Maximum number of modules assembled, or ROMs disassembled by --dis-batch, in parallel, 0 for one per hardware thread", cxxopts::value<unsigned int>()->default_value("0"))
+					("super", "Specify the target ISA to be the SUPER-CHIP and removes warning when using non CHIP-8 instructions")
+					("cache", "Reuse binaries previously assembled from the same source and options, stored in the given directory", cxxopts::value<std::string>()->implicit_value(".chasm-cache"))
+					("cache-size", "Maximum size in bytes of the build cache directory", cxxopts::value<uintmax_t>()->default_value("16777216"))
+					("incremental", "Reuse the encoding of unchanged procedures and labels from the state file of a previous build", cxxopts::value<std::string>()->implicit_value("out.c8i"))
+					("pipeline", "Run the lexer, the parser and the generator on separate threads, overlapping each other")
+					("ast-cache", "Keep the parsed source in a .c8a file next to it, to skip parsing when the source did not change")
+					("time-passes", "Report the wall time, CPU time, allocations and peak memory of every build pass")
+					("time-passes-json", "Write the time-passes report as JSON to the given file", cxxopts::value<std::string>())
+					("trace-out", "Record the passes, files, queue waits and cache hits of every thread to the given Chrome trace event file", cxxopts::value<std::string>())
+					("watch", "Keep running and assemble the input file again whenever it changes")
+					("watch-debounce", "Milliseconds without further changes to wait for before rebuilding", cxxopts::value<unsigned int>()->default_value("50"));
 
 			parameters = opts.parse(argc, argv);
 		}
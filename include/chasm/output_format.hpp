@@ -0,0 +1,75 @@
+#ifndef CHASM_OUTPUT_FORMAT_HPP
+#define CHASM_OUTPUT_FORMAT_HPP
+
+
+#include <string_view>
+#include <filesystem>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <chasm/arch.hpp>
+
+
+namespace chasm::output
+{
+	enum class format
+	{
+		raw,
+		ihex,
+		c_array,
+		base64,
+		hexdump
+	};
+
+	struct encode_parameters
+	{
+		//
+		// address the first byte is loaded at
+		//
+		arch::addr base = 0x200;
+
+		//
+		// bytes per line of the hexdump
+		//
+		unsigned int bytes_per_line = 4;
+
+		//
+		// name of the array declared by the C header
+		//
+		std::string_view array_name = "chasm_program";
+	};
+
+	[[nodiscard]] std::optional<format> parse_format(std::string_view name);
+
+	[[nodiscard]] std::string_view name(format fmt);
+
+	//
+	// Extension given to the file written in the format, along with its dot
+	//
+	[[nodiscard]] std::string_view extension(format fmt);
+
+	//
+	// Each format is encoded into a single buffer sized up front, so the cost does not
+	// depend on the stream it is written to afterwards
+	//
+	[[nodiscard]] std::string encode(format fmt, std::span<const uint8_t> binary, const encode_parameters& params = {});
+
+	struct output_file
+	{
+		format fmt;
+		std::filesystem::path path;
+	};
+
+	//
+	// The first format is written to the output file, the next ones next to it with their own extension.
+	// Throws before anything is written when a format is unknown or given twice, or when two formats
+	// would be written to the same file
+	//
+	[[nodiscard]] std::vector<output_file> output_files(const std::filesystem::path& ofile, std::span<const std::string> formats);
+}
+
+
+#endif //CHASM_OUTPUT_FORMAT_HPP
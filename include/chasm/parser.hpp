@@ -5,6 +5,8 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <string_view>
+#include <functional>
+#include <optional>
 #include <vector>
 #include <format>
 
@@ -55,12 +57,23 @@ namespace chasm
     class parser
     {
     public:
+		//
+		// Returns the next token, or nothing at the end of the input (and on every call after it)
+		//
+		using token_source = std::function<std::optional<token>()>;
+
         explicit parser(std::vector<token>&& tokens_list);
+        explicit parser(token_source source_);
 
         ~parser() = default;
 
         [[nodiscard]] ast::abstract_tree make_tree();
 
+		//
+		// Parses a single top-level statement, returns nullptr at the end of the input
+		//
+		[[nodiscard]] ast::statement next_statement();
+
     private:
 		template<typename... Args>
 		token expect(Args... types)
@@ -83,7 +96,7 @@ namespace chasm
 
 			std::unordered_set<token_type> expected_types { types... };
 
-			if (expected_types.contains(token_it->type))
+			if (expected_types.contains(peek()->type))
 			{
 				advance();
 				return true;
@@ -100,11 +113,12 @@ namespace chasm
 
 			std::unordered_set<token_type> set { types... };
 
-			return set.contains(token_it->type);
+			return set.contains(peek()->type);
 		};
 
 		token advance();
-        [[nodiscard]] bool no_more_tokens() const;
+		[[nodiscard]] const token* peek();
+        [[nodiscard]] bool no_more_tokens();
 
         [[nodiscard]] ast::statement parse_primary_statement();
         [[nodiscard]] ast::statement parse_raw();
@@ -118,8 +132,15 @@ namespace chasm
 		[[nodiscard]] std::vector<ast::instruction_operand> parse_operands();
 
     private:
-        const std::vector<token> tokens;
-        std::vector<token>::const_iterator token_it;
+		//
+		// The tokens are either all lexed beforehand and read in place, or pulled one at a time from a source
+		// through a lookahead, which only the pipelined mode does
+		//
+        std::vector<token> tokens;
+		size_t token_index = 0;
+
+        token_source source;
+		std::optional<token> lookahead;
     };
 }
 
@@ -0,0 +1,102 @@
+#ifndef CHASM_PASS_TIMER_HPP
+#define CHASM_PASS_TIMER_HPP
+
+
+#include <string_view>
+#include <filesystem>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <chasm/trace.hpp>
+
+
+namespace chasm::passes
+{
+	//
+	// Heap allocations made by the whole process while passes are enabled, counted by the
+	// replaced global operator new
+	//
+	struct allocation_stats
+	{
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	[[nodiscard]] allocation_stats allocations();
+
+	struct pass_record
+	{
+		std::string name;
+
+		//
+		// passes started while another one runs on the same thread are nested in it
+		//
+		size_t depth = 0;
+
+		double wall_ms = 0;
+		double cpu_ms = 0;
+		uint64_t allocation_count = 0;
+		uint64_t allocated_bytes = 0;
+
+		//
+		// peak resident set size of the process at the end of the pass
+		//
+		uint64_t peak_rss_kib = 0;
+	};
+
+	//
+	// Passes are only measured once enabled, a disabled scoped_pass does nothing
+	//
+	void enable(bool on = true);
+	[[nodiscard]] bool enabled();
+
+	//
+	// Passes measured so far, in the order they started
+	//
+	[[nodiscard]] std::vector<pass_record> records();
+	void clear();
+
+	//
+	// Table of the passes written to the log, and JSON document for tools tracking regressions
+	//
+	void report();
+	[[nodiscard]] std::string to_json();
+
+	///
+	/// Measures the wall time, CPU time and allocations of the enclosing scope as one pass.
+	///
+	/// CPU time and allocations are those of the whole process, passes running on
+	/// concurrent threads (pipeline stages, project modules) are counted in one another.
+	/// Passes are also recorded as spans when tracing is enabled.
+	///
+	class scoped_pass
+	{
+	public:
+		explicit scoped_pass(std::string_view name_);
+		~scoped_pass();
+
+		scoped_pass(const scoped_pass&) = delete;
+		scoped_pass(scoped_pass&&) = delete;
+		scoped_pass& operator=(const scoped_pass&) = delete;
+		scoped_pass& operator=(scoped_pass&&) = delete;
+
+	private:
+		trace::scoped_span span;
+
+		bool active;
+
+		//
+		// index of the record reserved when the pass started
+		//
+		size_t slot = 0;
+
+		std::chrono::steady_clock::time_point wall_start;
+		double cpu_start = 0;
+		allocation_stats allocations_start;
+	};
+}
+
+
+#endif //CHASM_PASS_TIMER_HPP
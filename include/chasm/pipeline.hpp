@@ -0,0 +1,23 @@
+#ifndef CHASM_PIPELINE_HPP
+#define CHASM_PIPELINE_HPP
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace chasm
+{
+	///
+	/// Assembles a source with the lexer, the parser and the sanitizer/generator each running
+	/// on their own thread, connected by bounded queues so the stages overlap.
+	///
+	/// Statements are sanitized as soon as they are parsed, then generated once the whole source
+	/// is sanitized, procedures last, giving the errors and the layout of abstract_tree::generate.
+	///
+	[[nodiscard]] std::vector<uint8_t> assemble_pipelined(std::string&& source);
+}
+
+
+#endif //CHASM_PIPELINE_HPP
@@ -0,0 +1,69 @@
+#ifndef CHASM_PROJECT_HPP
+#define CHASM_PROJECT_HPP
+
+
+#include <filesystem>
+#include <string_view>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <chasm/hash.hpp>
+
+
+namespace chasm
+{
+	///
+	/// Multi-module build described by a manifest file:
+	///
+	///     ;; modules are assembled to object files then linked together
+	///     output game.c8c
+	///     module utils src/utils.c8
+	///     module game  src/game.c8 utils
+	///
+	/// A module line gives the module name, its source path (relative to the manifest)
+	/// and the modules it depends on. Modules are assembled in dependency order, independent
+	/// ones in parallel, and a module is only assembled again when its source, the options
+	/// or one of its dependencies changed.
+	///
+	class project
+	{
+	public:
+		struct module
+		{
+			std::string name;
+			std::filesystem::path source;
+			std::vector<std::string> dependencies;
+		};
+
+		[[nodiscard]] static project load(const std::filesystem::path& manifest);
+		[[nodiscard]] static project parse(std::string_view manifest, const std::filesystem::path& root);
+
+		//
+		// Modules sorted so each one comes after its dependencies
+		//
+		[[nodiscard]] const std::vector<module>& modules() const;
+		[[nodiscard]] const std::optional<std::filesystem::path>& output() const;
+
+		//
+		// Assembles the outdated modules with up to `jobs` threads (0 for one per hardware thread)
+		// into the build directory, then links every module object into a binary
+		//
+		[[nodiscard]] std::vector<uint8_t> build(const std::filesystem::path& build_dir, unsigned int jobs) const;
+
+	private:
+		project() = default;
+
+		void sort_modules();
+
+		[[nodiscard]] std::vector<hasher::value_type> module_keys() const;
+		[[nodiscard]] size_t index_of(std::string_view name) const;
+
+	private:
+		std::vector<module> sorted_modules;
+		std::optional<std::filesystem::path> output_path;
+	};
+}
+
+
+#endif //CHASM_PROJECT_HPP
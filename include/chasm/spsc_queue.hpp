@@ -0,0 +1,149 @@
+#ifndef CHASM_SPSC_QUEUE_HPP
+#define CHASM_SPSC_QUEUE_HPP
+
+
+#include <condition_variable>
+#include <optional>
+#include <cstddef>
+#include <atomic>
+#include <array>
+#include <mutex>
+
+#include <chasm/trace.hpp>
+
+
+namespace chasm
+{
+	///
+	/// Bounded queue between exactly one producer thread and one consumer thread, lock-free as long
+	/// as neither side has to wait for the other, which then blocks on a condition variable.
+	///
+	/// The producer closes the queue once it pushed its last element. Either side can abort it
+	/// so the other one stops waiting, e.g. when a pipeline stage throws.
+	///
+	template<typename T, size_t Capacity>
+	class spsc_queue
+	{
+		static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	public:
+		spsc_queue() = default;
+		spsc_queue(const spsc_queue&) = delete;
+		spsc_queue(spsc_queue&&) = delete;
+		spsc_queue& operator=(const spsc_queue&) = delete;
+		spsc_queue& operator=(spsc_queue&&) = delete;
+		~spsc_queue() = default;
+
+		//
+		// Waits for a free slot, returns false if the queue was aborted
+		//
+		bool push(T&& value)
+		{
+			const auto tail = tail_index.load(std::memory_order_relaxed);
+
+			if (tail - head_index.load(std::memory_order_acquire) == Capacity)
+			{
+				//
+				// only started when the queue is found full, the time blocked shows up in the trace
+				//
+				trace::scoped_span waiting("queue full", "queue");
+
+				std::unique_lock lock(mutex);
+
+				producer_waiting.store(true);
+				changed.wait(lock, [&] { return aborted.load() || tail - head_index.load() != Capacity; });
+				producer_waiting.store(false);
+
+				if (aborted.load(std::memory_order_relaxed))
+					return false;
+			}
+
+			slots[tail & (Capacity - 1)] = std::move(value);
+			tail_index.store(tail + 1);
+
+			if (consumer_waiting.load())
+				wake();
+
+			return true;
+		}
+
+		//
+		// Waits for an element, returns nothing once the queue is closed and drained or aborted
+		//
+		std::optional<T> pop()
+		{
+			const auto head = head_index.load(std::memory_order_relaxed);
+
+			if (head == tail_index.load(std::memory_order_acquire))
+			{
+				trace::scoped_span waiting("queue empty", "queue");
+
+				std::unique_lock lock(mutex);
+
+				//
+				// closed is set after the last push, the tail is checked again once it is seen
+				//
+				consumer_waiting.store(true);
+				changed.wait(lock, [&] { return aborted.load() || closed.load() || head != tail_index.load(); });
+				consumer_waiting.store(false);
+
+				if (head == tail_index.load(std::memory_order_acquire))
+					return std::nullopt;
+			}
+
+			std::optional<T> value(std::move(slots[head & (Capacity - 1)]));
+			head_index.store(head + 1);
+
+			if (producer_waiting.load())
+				wake();
+
+			return value;
+		}
+
+		void close()
+		{
+			closed.store(true);
+			wake();
+		}
+
+		void abort()
+		{
+			aborted.store(true);
+			wake();
+		}
+
+	private:
+		//
+		// Taking the lock orders the notification after the waiter checked its condition
+		//
+		void wake()
+		{
+			std::scoped_lock lock(mutex);
+			changed.notify_all();
+		}
+
+	private:
+		//
+		// indices only grow, each one is written by a single side and kept on its own cache line
+		//
+		alignas(64) std::atomic<size_t> head_index = 0;
+		alignas(64) std::atomic<size_t> tail_index = 0;
+		alignas(64) std::atomic<bool> closed = false;
+		std::atomic<bool> aborted = false;
+
+		//
+		// A side that finds the queue full or empty sleeps until the other one moves its index.
+		// The flags and the indices are sequentially consistent, so either the waiter sees the
+		// index move or the other side sees the flag and wakes it.
+		//
+		std::atomic<bool> producer_waiting = false;
+		std::atomic<bool> consumer_waiting = false;
+		std::mutex mutex;
+		std::condition_variable changed;
+
+		std::array<T, Capacity> slots {};
+	};
+}
+
+
+#endif //CHASM_SPSC_QUEUE_HPP
@@ -0,0 +1,100 @@
+#ifndef CHASM_SYMBOL_FILE_HPP
+#define CHASM_SYMBOL_FILE_HPP
+
+
+#include <unordered_map>
+#include <string_view>
+#include <filesystem>
+#include <optional>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <span>
+
+#include <chasm/arch.hpp>
+
+
+namespace chasm
+{
+	using symbol_map = std::unordered_map<std::string, arch::addr>;
+
+	//
+	// Source line of the instruction starting at the given offset of the binary
+	//
+	struct source_line
+	{
+		arch::addr offset;
+		uint32_t line;
+	};
+
+	//
+	// One "<file offset> <memory address> --> <symbol>" line per symbol, by address then name
+	//
+	[[nodiscard]] std::string format_symbols_text(const symbol_map& symbols, arch::addr base);
+
+	//
+	// Binary symbols file, see symbol_index
+	//
+	[[nodiscard]] std::vector<uint8_t> make_symbol_index(const symbol_map& symbols,
+														 std::span<const source_line> lines,
+														 arch::addr base);
+
+	//
+	// Writes the symbols in the format given by the "symbols-format" option
+	//
+	void generate_symbols_file(const std::filesystem::path& path,
+							   const symbol_map& symbols,
+							   std::span<const source_line> lines = {});
+
+	///
+	/// Read-only view of a binary symbols file, meant to be used straight from a mapped file.
+	///
+	/// After a fixed header come the symbols sorted by memory address then name, the source lines
+	/// sorted by memory address, then the pool of symbol names. Every field is a 32 bits
+	/// little-endian integer so lookups binary search the tables in place.
+	///
+	class symbol_index
+	{
+	public:
+		struct symbol
+		{
+			std::string_view name;
+			arch::addr address;
+		};
+
+		//
+		// Throws when the bytes are not a well-formed binary symbols file
+		//
+		explicit symbol_index(std::span<const uint8_t> bytes_);
+
+		[[nodiscard]] arch::addr base() const;
+
+		[[nodiscard]] size_t symbol_count() const;
+		[[nodiscard]] symbol symbol_at(size_t index) const;
+
+		//
+		// Symbol with the highest address not above the given memory address,
+		// i.e. the procedure, label or sprite containing it
+		//
+		[[nodiscard]] std::optional<symbol> find(arch::addr address) const;
+
+		//
+		// Source line of the instruction containing the given memory address
+		//
+		[[nodiscard]] std::optional<uint32_t> line_of(arch::addr address) const;
+
+	private:
+		[[nodiscard]] uint32_t field(size_t offset) const;
+
+	private:
+		std::span<const uint8_t> bytes;
+
+		size_t symbols_count = 0;
+		size_t lines_count = 0;
+		size_t lines_offset = 0;
+		size_t pool_offset = 0;
+	};
+}
+
+
+#endif //CHASM_SYMBOL_FILE_HPP
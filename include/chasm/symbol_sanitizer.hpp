@@ -25,6 +25,12 @@ namespace chasm
 
 	public:
 		symbol_sanitizer() = default;
+
+		//
+		// A relocatable tree is assembled into an object file: calls to procedures
+		// defined in other objects are allowed and the entry point is optional
+		//
+		explicit symbol_sanitizer(bool relocatable);
 		symbol_sanitizer(const symbol_sanitizer&) = delete;
 		symbol_sanitizer(symbol_sanitizer&&) = delete;
 		symbol_sanitizer& operator=(const symbol_sanitizer&) = delete;
@@ -33,6 +39,11 @@ namespace chasm
 
 		void traverse(const ast::abstract_tree&);
 
+		//
+		// Checks left once every statement was visited, when they are not traversed from a tree
+		//
+		void finalize();
+
 		void visit(const ast::procedure_statement&) override;
 		void visit(const ast::instruction_statement&) override;
 		void visit(const ast::define_statement&) override;
@@ -42,7 +53,6 @@ namespace chasm
 
 
 	private:
-		void post_visit();
 		void push_scope();
 		void pop_scope();
 		void register_symbol(std::string&& symbol, const source_location& sym_loc);
@@ -56,6 +66,7 @@ namespace chasm
 		scope_id curr_scope_level = 0;
 		symbol_set undefined_labels;
 		symbol_set undefined_procs;
+		bool relocatable = false;
 	};
 
 
@@ -0,0 +1,64 @@
+#ifndef CHASM_TRACE_HPP
+#define CHASM_TRACE_HPP
+
+
+#include <string_view>
+#include <filesystem>
+#include <cstdint>
+#include <string>
+
+
+namespace chasm::trace
+{
+	//
+	// Events are only recorded once enabled, spans and markers do nothing otherwise
+	//
+	void enable(bool on = true);
+	[[nodiscard]] bool enabled();
+
+	//
+	// Names the calling thread in the trace, e.g. "lexer" or "worker 2"
+	//
+	void set_thread_name(std::string_view name);
+
+	//
+	// Point in time event, e.g. a cache hit or miss
+	//
+	void instant(std::string_view name, std::string_view category, std::string_view detail = {});
+
+	//
+	// Writes every event recorded since the previous write in the Chrome trace event format, loadable by
+	// chrome://tracing and Perfetto, then drops them. The threads that recorded them must be done.
+	//
+	void write(const std::filesystem::path& path);
+
+	///
+	/// Records the enclosing scope as a span of the calling thread.
+	///
+	/// Each thread appends its events to its own buffer, registered once under a lock
+	/// the first time the thread records something, so recording never waits on other threads.
+	///
+	class scoped_span
+	{
+	public:
+		scoped_span(std::string_view name_, std::string_view category_, std::string_view detail_ = {});
+		~scoped_span();
+
+		scoped_span(const scoped_span&) = delete;
+		scoped_span(scoped_span&&) = delete;
+		scoped_span& operator=(const scoped_span&) = delete;
+		scoped_span& operator=(scoped_span&&) = delete;
+
+	private:
+		bool active;
+
+		std::string_view name;
+		std::string_view category;
+		std::string_view detail;
+
+		double start_us = 0;
+	};
+}
+
+
+#endif //CHASM_TRACE_HPP
@@ -0,0 +1,18 @@
+#ifndef CHASM_VERSION_HPP
+#define CHASM_VERSION_HPP
+
+
+#include <string_view>
+
+
+namespace chasm
+{
+	//
+	// Bump whenever the generated machine code may change for a same source,
+	// cached artifacts are keyed by it
+	//
+	constexpr std::string_view version = "0.1.2";
+}
+
+
+#endif //CHASM_VERSION_HPP
@@ -0,0 +1,193 @@
+#ifndef CHASM_WORK_STEALING_POOL_HPP
+#define CHASM_WORK_STEALING_POOL_HPP
+
+
+#include <condition_variable>
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+
+namespace chasm
+{
+	///
+	/// Runs tasks, and the tasks they spawn, on a fixed number of threads until none is left.
+	///
+	/// Each thread keeps the tasks it spawns in its own deque and takes the last one first, so it
+	/// goes on with what is still hot in its cache. Threads running out of tasks steal the oldest
+	/// task of another deque, and sleep when there is nothing to steal until a task is spawned or
+	/// the last one is done. The first exception thrown by a task stops every thread and is
+	/// rethrown by run.
+	///
+	template<typename Task>
+	class work_stealing_pool
+	{
+	public:
+		explicit work_stealing_pool(size_t threads)
+			: queues(std::max<size_t>(threads, 1))
+		{}
+
+		work_stealing_pool(const work_stealing_pool&) = delete;
+		work_stealing_pool(work_stealing_pool&&) = delete;
+		work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+		work_stealing_pool& operator=(work_stealing_pool&&) = delete;
+		~work_stealing_pool() = default;
+
+		//
+		// Calls process(task, worker, spawn) for every task, worker being the index of the thread
+		// running it and spawn(Task) queuing another task
+		//
+		template<typename Process>
+		void run(std::vector<Task> seeds, Process process)
+		{
+			pending = seeds.size();
+
+			for (size_t i = 0; i < seeds.size(); ++i)
+				queues[i % queues.size()].tasks.push_back(std::move(seeds[i]));
+
+			{
+				std::vector<std::jthread> workers;
+
+				for (size_t worker = 0; worker < queues.size(); ++worker)
+					workers.emplace_back([this, worker, &process] { work(worker, process); });
+			}
+
+			if (failure)
+				std::rethrow_exception(failure);
+		}
+
+	private:
+		struct worker_queue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		template<typename Process>
+		void work(size_t worker, Process& process)
+		{
+			const auto spawn = [this, worker](Task task)
+			{
+				//
+				// counted before it can be taken, so pending never drops to zero while tasks are left
+				//
+				pending.fetch_add(1);
+
+				{
+					std::scoped_lock lock(queues[worker].mutex);
+					queues[worker].tasks.push_back(std::move(task));
+				}
+
+				wake(false);
+			};
+
+			while (pending.load() > 0 && !stopped.load())
+			{
+				//
+				// read before looking for a task, so a task spawned after the search changed it and is not missed
+				//
+				const auto seen = generation.load();
+				auto task = take(worker);
+
+				if (!task)
+				{
+					std::unique_lock lock(idle_mutex);
+
+					idle.wait(lock, [&]
+					{
+						return generation.load() != seen || pending.load() == 0 || stopped.load();
+					});
+
+					continue;
+				}
+
+				try
+				{
+					process(std::move(*task), worker, spawn);
+				}
+				catch (...)
+				{
+					std::scoped_lock lock(failure_mutex);
+
+					if (!failure)
+						failure = std::current_exception();
+
+					stopped = true;
+				}
+
+				if (pending.fetch_sub(1) == 1 || stopped.load())
+					wake(true);
+			}
+		}
+
+		void wake(bool everyone)
+		{
+			{
+				std::scoped_lock lock(idle_mutex);
+				generation.fetch_add(1);
+			}
+
+			if (everyone)
+				idle.notify_all();
+			else
+				idle.notify_one();
+		}
+
+		std::optional<Task> take(size_t worker)
+		{
+			{
+				auto& own = queues[worker];
+				std::scoped_lock lock(own.mutex);
+
+				if (!own.tasks.empty())
+				{
+					auto task = std::move(own.tasks.back());
+					own.tasks.pop_back();
+
+					return task;
+				}
+			}
+
+			for (size_t i = 1; i < queues.size(); ++i)
+			{
+				auto& victim = queues[(worker + i) % queues.size()];
+				std::scoped_lock lock(victim.mutex);
+
+				if (!victim.tasks.empty())
+				{
+					auto task = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+
+					return task;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+	private:
+		std::vector<worker_queue> queues;
+		std::atomic<size_t> pending = 0;
+		std::atomic<bool> stopped = false;
+
+		//
+		// bumped under the idle mutex whenever a sleeping thread may have something to do
+		//
+		std::mutex idle_mutex;
+		std::condition_variable idle;
+		std::atomic<uint64_t> generation = 0;
+
+		std::mutex failure_mutex;
+		std::exception_ptr failure;
+	};
+}
+
+
+#endif //CHASM_WORK_STEALING_POOL_HPP
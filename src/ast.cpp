@@ -1,5 +1,6 @@
 #include <chasm/ast.hpp>
 #include <chasm/symbol_sanitizer.hpp>
+#include <chasm/pass_timer.hpp>
 #include <chasm/generator.hpp>
 
 
@@ -9,28 +10,67 @@ namespace chasm::ast
 		: statements(std::move(branches))
 	{}
 
+	abstract_tree::abstract_tree(std::vector<ast::statement>&& branches, std::shared_ptr<const void> storage_)
+		: statements(std::move(branches))
+		, storage(std::move(storage_))
+	{}
+
 	std::vector<uint8_t> abstract_tree::generate()
 	{
 		sanitize();
+		sort_statements();
 
-		std::ranges::stable_sort(statements, [](const ast::statement& a,
-												const ast::statement& b)
-		{
-			return a->priority() > b->priority();
-		});
+		passes::scoped_pass pass("generate");
 
 		generator generator;
 
 		return generator.generate(*this);
 	}
 
-	void abstract_tree::sanitize() const
+	std::vector<uint8_t> abstract_tree::generate(incremental_state& state)
 	{
-		symbol_sanitizer sanitizer;
+		sanitize();
+		sort_statements();
+
+		passes::scoped_pass pass("generate");
+
+		generator generator(state);
+
+		return generator.generate(*this);
+	}
+
+	object_file abstract_tree::generate_object()
+	{
+		sanitize(true);
+		sort_statements();
+
+		passes::scoped_pass pass("generate");
+
+		generator generator;
+
+		return generator.generate_object(*this);
+	}
+
+	void abstract_tree::sanitize(bool relocatable) const
+	{
+		passes::scoped_pass pass("sanitize");
+
+		symbol_sanitizer sanitizer(relocatable);
 
 		sanitizer.traverse(*this);
 	}
 
+	void abstract_tree::sort_statements()
+	{
+		passes::scoped_pass pass("sort");
+
+		std::ranges::stable_sort(statements, [](const ast::statement& a,
+												const ast::statement& b)
+		{
+			return a->priority() > b->priority();
+		});
+	}
+
 	const std::vector<ast::statement>& abstract_tree::branches() const
 	{
 		return statements;
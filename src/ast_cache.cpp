@@ -0,0 +1,395 @@
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+
+#include <chasm/ast_cache.hpp>
+#include <chasm/binary_io.hpp>
+#include <chasm/statements.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/version.hpp>
+#include <chasm/log.hpp>
+
+
+namespace chasm::ast_cache
+{
+	namespace
+	{
+		constexpr std::string_view AST_MAGIC = "C8A";
+		constexpr uint8_t AST_FORMAT = 1;
+
+		//
+		// procedures may contain labels, nothing is nested deeper
+		//
+		constexpr int MAX_NESTING = 2;
+
+		enum class statement_kind : uint8_t
+		{
+			procedure,
+			instruction,
+			define,
+			config,
+			sprite,
+			raw,
+			label
+		};
+
+		enum class operand_kind : uint8_t
+		{
+			immediate,
+			reg,
+			indirection,
+			label,
+			procedure,
+			sprite
+		};
+
+		operand_kind kind_of(const ast::instruction_operand& operand)
+		{
+			if (operand.is_reg())          return operand_kind::reg;
+			if (operand.has_indirection()) return operand_kind::indirection;
+			if (operand.is_label())        return operand_kind::label;
+			if (operand.is_procedure())    return operand_kind::procedure;
+			if (operand.is_sprite())       return operand_kind::sprite;
+
+			return operand_kind::immediate;
+		}
+
+		class tree_writer final : public ast::base_visitor
+		{
+		public:
+			explicit tree_writer(binary_writer& statements_)
+				: statements(statements_)
+			{}
+
+			void visit(const ast::procedure_statement& statement) override
+			{
+				write(statement_kind::procedure);
+				write(statement.name_beg);
+				write(statement.name_end);
+				write(statement.inner_statements);
+			}
+
+			void visit(const ast::instruction_statement& statement) override
+			{
+				write(statement_kind::instruction);
+				write(statement.mnemonic);
+
+				statements.write(static_cast<uint8_t>(statement.operands.size()));
+
+				for (const auto& operand : statement.operands)
+				{
+					statements.write(static_cast<uint8_t>(kind_of(operand)));
+					write(operand.operand);
+				}
+			}
+
+			void visit(const ast::define_statement& statement) override
+			{
+				write(statement_kind::define);
+				write(statement.identifier);
+				write(statement.value);
+			}
+
+			void visit(const ast::config_statement& statement) override
+			{
+				write(statement_kind::config);
+				write(statement.identifier);
+				write(statement.value);
+			}
+
+			void visit(const ast::sprite_statement& statement) override
+			{
+				write(statement_kind::sprite);
+				write(statement.identifier);
+
+				statements.write(statement.sprite.row_count)
+						  .write_raw(std::span(statement.sprite.data.begin(), statement.sprite.row_count));
+			}
+
+			void visit(const ast::raw_statement& statement) override
+			{
+				write(statement_kind::raw);
+				write(statement.opcode);
+			}
+
+			void visit(const ast::label_statement& statement) override
+			{
+				write(statement_kind::label);
+				write(statement.identifier);
+				write(statement.inner_statements);
+			}
+
+			void write(const std::vector<ast::statement>& inner)
+			{
+				statements.write(static_cast<uint32_t>(inner.size()));
+
+				for (const auto& statement : inner)
+					statement->accept(*this);
+			}
+
+			[[nodiscard]] const std::vector<std::string_view>& strings() const
+			{
+				return pool;
+			}
+
+		private:
+			void write(statement_kind kind)
+			{
+				statements.write(static_cast<uint8_t>(kind));
+			}
+
+			void write(const token& t)
+			{
+				statements.write(static_cast<uint8_t>(t.type))
+						  .write(static_cast<uint32_t>(t.source_location.line))
+						  .write(static_cast<uint32_t>(t.source_location.col));
+
+				if (std::holds_alternative<uint16_t>(t.data))
+				{
+					statements.write(uint8_t { 0 }).write(std::get<uint16_t>(t.data));
+					return;
+				}
+
+				const auto str = t.text();
+				const auto [it, inserted] = indices.try_emplace(str, static_cast<uint32_t>(pool.size()));
+
+				if (inserted)
+					pool.push_back(it->first);
+
+				statements.write(uint8_t { 1 }).write(it->second);
+			}
+
+		private:
+			binary_writer& statements;
+
+			//
+			// interned strings, viewing the tokens of the tree being written
+			//
+			std::unordered_map<std::string_view, uint32_t> indices;
+			std::vector<std::string_view> pool;
+		};
+
+		class tree_reader
+		{
+		public:
+			tree_reader(binary_reader& reader_, std::vector<std::string_view>&& pool_)
+				: reader(reader_),
+				  pool(std::move(pool_))
+			{}
+
+			std::vector<ast::statement> read_statements(int depth = 0)
+			{
+				if (depth > MAX_NESTING)
+					throw chasm_exception("Statements nested too deeply");
+
+				std::vector<ast::statement> statements;
+
+				//
+				// counts are not trusted to reserve memory, a corrupted file runs out of data instead
+				//
+				for (auto count = reader.read<uint32_t>(); count > 0; --count)
+					statements.push_back(read_statement(depth));
+
+				return statements;
+			}
+
+		private:
+			ast::statement read_statement(int depth)
+			{
+				switch (static_cast<statement_kind>(reader.read<uint8_t>()))
+				{
+					case statement_kind::procedure:
+					{
+						auto name_beg = read_token();
+						auto name_end = read_token();
+
+						return std::make_unique<ast::procedure_statement>(std::move(name_beg),
+																		  std::move(name_end),
+																		  read_statements(depth + 1));
+					}
+
+					case statement_kind::instruction:
+					{
+						auto mnemonic = read_token();
+						std::vector<ast::instruction_operand> operands;
+
+						for (auto count = reader.read<uint8_t>(); count > 0; --count)
+							operands.push_back(read_operand());
+
+						return std::make_unique<ast::instruction_statement>(std::move(mnemonic), std::move(operands));
+					}
+
+					case statement_kind::define:
+					{
+						auto identifier = read_token();
+						return std::make_unique<ast::define_statement>(std::move(identifier), read_token());
+					}
+
+					case statement_kind::config:
+					{
+						auto identifier = read_token();
+						return std::make_unique<ast::config_statement>(std::move(identifier), read_token());
+					}
+
+					case statement_kind::sprite:
+					{
+						auto identifier = read_token();
+
+						arch::sprite sprite {};
+						sprite.row_count = reader.read<uint8_t>();
+
+						if (sprite.row_count > sprite.data.size())
+							throw chasm_exception("Sprite with {} rows", sprite.row_count);
+
+						std::ranges::copy(reader.read_raw(sprite.row_count), sprite.data.begin());
+
+						return std::make_unique<ast::sprite_statement>(std::move(identifier), sprite);
+					}
+
+					case statement_kind::raw:
+						return std::make_unique<ast::raw_statement>(read_token());
+
+					case statement_kind::label:
+					{
+						auto identifier = read_token();
+						return std::make_unique<ast::label_statement>(std::move(identifier), read_statements(depth + 1));
+					}
+
+					default:
+						throw chasm_exception("Unknown statement kind");
+				}
+			}
+
+			ast::instruction_operand read_operand()
+			{
+				const auto kind = static_cast<operand_kind>(reader.read<uint8_t>());
+				auto operand = read_token();
+
+				switch (kind)
+				{
+					case operand_kind::immediate:   return ast::instruction_operand::make_immediate(std::move(operand));
+					case operand_kind::reg:         return ast::instruction_operand::make_reg(std::move(operand));
+					case operand_kind::indirection: return ast::instruction_operand::make_indirect(std::move(operand));
+					case operand_kind::label:       return ast::instruction_operand::make_label(std::move(operand));
+					case operand_kind::procedure:   return ast::instruction_operand::make_proc(std::move(operand));
+					case operand_kind::sprite:      return ast::instruction_operand::make_sprite(std::move(operand));
+
+					default:
+						throw chasm_exception("Unknown operand kind");
+				}
+			}
+
+			token read_token()
+			{
+				token t {};
+
+				const auto type = reader.read<uint8_t>();
+
+				if (type > static_cast<uint8_t>(token_type::equal))
+					throw chasm_exception("Unknown token type {}", type);
+
+				t.type = static_cast<token_type>(type);
+				t.source_location.line = reader.read<uint32_t>();
+				t.source_location.col = reader.read<uint32_t>();
+
+				if (reader.read<uint8_t>() == 0)
+				{
+					t.data = reader.read<uint16_t>();
+					return t;
+				}
+
+				const auto index = reader.read<uint32_t>();
+
+				if (index >= pool.size())
+					throw chasm_exception("String index {} out of range", index);
+
+				t.data = pool[index];
+
+				return t;
+			}
+
+		private:
+			binary_reader& reader;
+			std::vector<std::string_view> pool;
+		};
+	}
+
+	std::filesystem::path path_for(const std::filesystem::path& source)
+	{
+		return std::filesystem::path(source).replace_extension(".c8a");
+	}
+
+	key_type make_key(std::string_view source)
+	{
+		return hasher().update(source).digest();
+	}
+
+	std::optional<ast::abstract_tree> load(const std::filesystem::path& path, key_type source_key)
+	{
+		auto file = mapped_file::open(path);
+
+		if (!file)
+			return std::nullopt;
+
+		//
+		// the tokens view their strings in the file instead of copying them, the tree owns it
+		//
+		auto storage = std::make_shared<const mapped_file>(std::move(*file));
+
+		try
+		{
+			binary_reader reader(storage->bytes());
+
+			const auto magic = reader.read_raw(AST_MAGIC.size());
+
+			if (!std::ranges::equal(magic, AST_MAGIC) ||
+				reader.read<uint8_t>() != AST_FORMAT ||
+				reader.read_string() != version ||
+				reader.read<key_type>() != source_key)
+				return std::nullopt;
+
+			std::vector<std::string_view> pool;
+
+			for (auto count = reader.read<uint32_t>(); count > 0; --count)
+				pool.push_back(reader.read_string());
+
+			return ast::abstract_tree(tree_reader(reader, std::move(pool)).read_statements(), std::move(storage));
+		}
+		catch (const chasm_exception& error)
+		{
+			log::warn("Parsed tree file \"{}\" is corrupted and was ignored: {}", path.string(), error.what());
+		}
+
+		return std::nullopt;
+	}
+
+	void store(const std::filesystem::path& path, key_type source_key, const ast::abstract_tree& tree)
+	{
+		binary_writer statements;
+		tree_writer visitor(statements);
+
+		visitor.write(tree.branches());
+
+		binary_writer writer;
+
+		writer.write_raw(std::span(reinterpret_cast<const uint8_t*>(AST_MAGIC.data()), AST_MAGIC.size()))
+			  .write(AST_FORMAT)
+			  .write(version)
+			  .write(source_key)
+			  .write(static_cast<uint32_t>(visitor.strings().size()));
+
+		for (const auto str : visitor.strings())
+			writer.write(str);
+
+		writer.write_raw(statements.data());
+
+		try
+		{
+			write_atomic(path, std::span(reinterpret_cast<const char*>(writer.data().data()), writer.size()));
+		}
+		catch (const std::exception& error)
+		{
+			log::warn("Could not write parsed tree file \"{}\": {}", path.string(), error.what());
+		}
+	}
+}
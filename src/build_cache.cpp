@@ -0,0 +1,207 @@
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <format>
+
+#include <chasm/build_cache.hpp>
+#include <chasm/chasm_exception.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/options.hpp>
+#include <chasm/version.hpp>
+#include <chasm/arch.hpp>
+#include <chasm/log.hpp>
+
+
+namespace chasm
+{
+	namespace
+	{
+		constexpr std::string_view BINARY_EXT  = ".c8c";
+		constexpr std::string_view SYMBOLS_EXT = ".c8s";
+		constexpr std::string_view TEMP_EXT    = ".tmp";
+
+		//
+		// temporary files older than this were left by a crashed invocation
+		//
+		constexpr auto STALE_TEMP_AGE = std::chrono::minutes(10);
+
+		template<typename Container>
+		std::optional<Container> read_file(const std::filesystem::path& path)
+		{
+			std::ifstream is(path, std::ios::binary);
+
+			if (!is)
+				return std::nullopt;
+
+			Container content;
+			std::error_code ec;
+			const auto size = std::filesystem::file_size(path, ec);
+
+			if (!ec)
+				content.resize(size);
+
+			is.read(reinterpret_cast<char*>(content.data()), static_cast<std::streamsize>(content.size()));
+
+			if (!is)
+				return std::nullopt;
+
+			return content;
+		}
+	}
+
+	build_cache::build_cache(std::filesystem::path directory, uintmax_t max_size_)
+		: root(std::move(directory)),
+		  max_size(max_size_)
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(root, ec);
+
+		if (ec)
+			throw chasm_exception("Could not create build cache directory \"{}\": {}", root.string(), ec.message());
+	}
+
+	build_cache::key_type build_cache::make_key(std::string_view source)
+	{
+		hasher h;
+
+		h.update(version)
+		 .update(options::arg<arch::addr>("relocate"))
+		 .update(options::has_flag("super"))
+		 .update(options::has_flag("pad-sprites"))
+		 .update(options::has_flag("object"))
+		 .update(std::string_view(options::arg<std::string>("symbols-format")))
+		 .update(source);
+
+		return h.digest();
+	}
+
+	std::filesystem::path build_cache::entry_path(key_type key, std::string_view extension) const
+	{
+		return root / std::format("{:016x}{}", key, extension);
+	}
+
+	std::optional<build_cache::entry> build_cache::lookup(key_type key, bool with_symbols) const
+	{
+		const auto binary_path = entry_path(key, BINARY_EXT);
+
+		//
+		// Entries may be evicted by another invocation at any time, a file
+		// that cannot be read is simply a miss
+		//
+		auto binary = read_file<std::vector<uint8_t>>(binary_path);
+
+		if (!binary)
+			return std::nullopt;
+
+		std::optional<std::string> symbols;
+
+		if (with_symbols)
+		{
+			symbols = read_file<std::string>(entry_path(key, SYMBOLS_EXT));
+
+			if (!symbols)
+				return std::nullopt;
+		}
+
+		//
+		// refresh the entry so eviction drops the least recently used ones first
+		//
+		std::error_code ec;
+		std::filesystem::last_write_time(binary_path, std::filesystem::file_time_type::clock::now(), ec);
+
+		return entry { .binary = std::move(*binary), .symbols = std::move(symbols) };
+	}
+
+	void build_cache::store(key_type key, const std::vector<uint8_t>& binary, const std::optional<std::string>& symbols) const
+	{
+		try
+		{
+			//
+			// The binary is the entry marker looked up first, so it is published last
+			//
+			if (symbols)
+				write_atomic(entry_path(key, SYMBOLS_EXT), *symbols);
+
+			write_atomic(entry_path(key, BINARY_EXT),
+						 std::span(reinterpret_cast<const char*>(binary.data()), binary.size()));
+
+			evict();
+		}
+		catch (const std::exception& error)
+		{
+			log::warn("Could not store build in cache: {}", error.what());
+		}
+	}
+
+	void build_cache::evict() const
+	{
+		struct entry_usage
+		{
+			uintmax_t size {};
+			std::filesystem::file_time_type last_use {};
+			std::vector<std::filesystem::path> files;
+		};
+
+		std::unordered_map<std::string, entry_usage> entries;
+		uintmax_t total_size = 0;
+
+		const auto now = std::filesystem::file_time_type::clock::now();
+		std::error_code ec;
+
+		for (const auto& file : std::filesystem::directory_iterator(root, ec))
+		{
+			if (!file.is_regular_file(ec))
+				continue;
+
+			const auto& path = file.path();
+			const auto size = file.file_size(ec);
+			const auto time = file.last_write_time(ec);
+
+			if (ec)
+				continue;
+
+			if (path.extension() == TEMP_EXT)
+			{
+				if (now - time > STALE_TEMP_AGE)
+					std::filesystem::remove(path, ec);
+
+				continue;
+			}
+
+			if (path.extension() != BINARY_EXT && path.extension() != SYMBOLS_EXT)
+				continue;
+
+			auto& usage = entries[path.stem().string()];
+			usage.size += size;
+			usage.last_use = std::max(usage.last_use, time);
+			usage.files.push_back(path);
+
+			total_size += size;
+		}
+
+		if (total_size <= max_size)
+			return;
+
+		std::vector<entry_usage*> by_age;
+
+		for (auto& [_, usage] : entries)
+			by_age.push_back(&usage);
+
+		std::ranges::sort(by_age, {}, &entry_usage::last_use);
+
+		for (const auto* usage : by_age)
+		{
+			if (total_size <= max_size)
+				break;
+
+			//
+			// another invocation may have removed it already, that is fine
+			//
+			for (const auto& path : usage->files)
+				std::filesystem::remove(path, ec);
+
+			total_size -= usage->size;
+		}
+	}
+}
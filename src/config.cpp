@@ -29,5 +29,9 @@ namespace chasm
 		else
 			log::warn("Invalid config id \"{}\", ignored", id);
 	}
-}
 
+	const std::unordered_map<std::string_view, int>& config::values() const
+	{
+		return storage;
+	}
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <format>
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include <chasm/ds/source_listing.hpp>
+#include <chasm/ds/batch.hpp>
+#include <chasm/chasm_exception.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/trace.hpp>
+
+
+namespace chasm::ds
+{
+	bool glob_matches(std::string_view pattern, std::string_view name)
+	{
+		size_t p = 0;
+		size_t n = 0;
+
+		//
+		// where the last '*' was met, and the character of the name it is matched up to
+		//
+		std::optional<size_t> star;
+		size_t star_end = 0;
+
+		while (n < name.size())
+		{
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+			{
+				++p;
+				++n;
+			}
+			else if (p < pattern.size() && pattern[p] == '*')
+			{
+				star = p++;
+				star_end = n;
+			}
+			else if (star)
+			{
+				p = *star + 1;
+				n = ++star_end;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		while (p < pattern.size() && pattern[p] == '*')
+			++p;
+
+		return p == pattern.size();
+	}
+
+	std::vector<batch_input> expand_batch(std::span<const std::string> arguments)
+	{
+		std::vector<batch_input> inputs;
+
+		for (const auto& argument : arguments)
+		{
+			const std::filesystem::path path(argument);
+			const auto pattern = path.filename().string();
+			const auto found = inputs.size();
+
+			if (pattern.find_first_of("*?") != std::string::npos)
+			{
+				const auto directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+
+				if (std::filesystem::is_directory(directory))
+				{
+					for (const auto& entry : std::filesystem::directory_iterator(directory))
+						if (entry.is_regular_file() && glob_matches(pattern, entry.path().filename().string()))
+							inputs.push_back({ entry.path(), entry.path().filename() });
+				}
+			}
+			else if (std::filesystem::is_directory(path))
+			{
+				for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+					if (entry.is_regular_file() && std::ranges::contains(ROM_EXTENSIONS, entry.path().extension().string()))
+						inputs.push_back({ entry.path(), entry.path().lexically_relative(path) });
+			}
+			else if (std::filesystem::is_regular_file(path))
+			{
+				inputs.push_back({ path, path.filename() });
+			}
+
+			if (inputs.size() == found)
+				throw chasm_exception("No ROM matches \"{}\"", argument);
+		}
+
+		std::ranges::sort(inputs, {}, &batch_input::rom);
+
+		const auto duplicates = std::ranges::unique(inputs, {}, &batch_input::rom);
+		inputs.erase(duplicates.begin(), duplicates.end());
+
+		return inputs;
+	}
+
+	disassembly_batch::disassembly_batch(arch::addr base_, disassembly_mode mode_, std::optional<std::filesystem::path> output_dir_)
+		: base(base_)
+		, mode(mode_)
+		, output_dir(std::move(output_dir_))
+	{}
+
+	std::vector<batch_result> disassembly_batch::run(std::span<const batch_input> inputs, unsigned int jobs) const
+	{
+		std::vector<batch_result> results(inputs.size());
+
+		//
+		// ROMs of the same name found under two directories, or with two extensions, have the same listing.
+		// None of them is written rather than one silently replacing the others
+		//
+		std::map<std::filesystem::path, size_t> listed;
+
+		const auto collide = [&](size_t i, size_t other)
+		{
+			if (!results[i].error)
+				results[i].error = std::format("Its listing {} would also be written for {}",
+											   results[i].listing.string(),
+											   inputs[other].rom.string());
+		};
+
+		for (size_t i = 0; i < inputs.size(); ++i)
+		{
+			results[i] = { inputs[i].rom, listing_path(inputs[i]), std::nullopt };
+
+			const auto [first, inserted] = listed.try_emplace(results[i].listing.lexically_normal(), i);
+
+			if (!inserted)
+			{
+				collide(i, first->second);
+				collide(first->second, i);
+			}
+		}
+
+		//
+		// ROMs are independent from each other, the threads take the next one until none is left
+		//
+		std::atomic<size_t> next = 0;
+
+		const auto worker = [&](size_t worker_index)
+		{
+			trace::set_thread_name(std::format("worker {}", worker_index));
+
+			for (size_t i = next.fetch_add(1); i < inputs.size(); i = next.fetch_add(1))
+				if (!results[i].error)
+					results[i] = disassemble(inputs[i]);
+		};
+
+		if (jobs == 0)
+			jobs = std::max(1u, std::thread::hardware_concurrency());
+
+		{
+			std::vector<std::jthread> workers;
+
+			for (size_t i = 0; i < std::min<size_t>(jobs, inputs.size()); ++i)
+				workers.emplace_back(worker, i);
+		}
+
+		return results;
+	}
+
+	std::filesystem::path disassembly_batch::listing_path(const batch_input& input) const
+	{
+		auto listing = output_dir ? *output_dir / input.relative : input.rom;
+		return listing.replace_extension(".c8");
+	}
+
+	batch_result disassembly_batch::disassemble(const batch_input& input) const
+	{
+		trace::scoped_span span("rom", "file", input.rom.string());
+
+		const auto listing = listing_path(input);
+
+		batch_result result { input.rom, listing, std::nullopt };
+
+		try
+		{
+			if (listing == input.rom)
+				throw chasm_exception("The listing would overwrite the ROM");
+
+			const auto file = mapped_file::open(input.rom);
+
+			if (!file)
+				throw chasm_exception("Could not open the ROM");
+
+			if (file->bytes().empty())
+				throw chasm_exception("The ROM is empty");
+
+			const std::vector<uint8_t> bytes(file->bytes().begin(), file->bytes().end());
+
+			const auto graph = disassembler(bytes, base, mode).get_graph();
+			const auto source = render_source(bytes, base, graph);
+
+			if (listing.has_parent_path())
+				std::filesystem::create_directories(listing.parent_path());
+
+			write_atomic(listing, source);
+		}
+		catch (const std::exception& error)
+		{
+			result.error = error.what();
+		}
+
+		return result;
+	}
+
+	void disassembly_batch::write_report(std::ostream& os, std::span<const batch_result> results)
+	{
+		for (const auto& result : results)
+		{
+			if (result.error)
+				os << std::format("failed\t{}\t{}\n", result.rom.string(), *result.error);
+			else
+				os << std::format("ok\t{}\t{}\n", result.rom.string(), result.listing.string());
+		}
+	}
+}
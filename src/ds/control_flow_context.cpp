@@ -3,6 +3,23 @@
 
 namespace chasm::ds
 {
+	void address_bitmap::set(arch::addr address)
+	{
+		const size_t word = address / 64;
+
+		if (word >= words.size())
+			words.resize(word + 1);
+
+		words[word] |= uint64_t(1) << (address % 64);
+	}
+
+	bool address_bitmap::test(arch::addr address) const
+	{
+		const size_t word = address / 64;
+
+		return word < words.size() && (words[word] >> (address % 64) & 1) != 0;
+	}
+
 	analysis_path::analysis_path(arch::addr start)
 		: path(start)
 	{}
@@ -33,12 +50,13 @@ namespace chasm::ds
 
 	procedure analysis_procedure::to_procedure()
 	{
-		auto ret = procedure(this->entrypoint());
+		std::vector<path> paths;
+		paths.reserve(analysis_paths.size());
 
 		for (analysis_path& p : analysis_paths)
-			ret.insert_path(std::move(p));
+			paths.push_back(std::move(p));
 
-		return ret;
+		return procedure(this->entrypoint(), std::move(paths));
 	}
 
 	const std::vector<analysis_path>& analysis_procedure::analyzed_paths() const
@@ -46,6 +64,16 @@ namespace chasm::ds
 		return analysis_paths;
 	}
 
+	void analysis_procedure::mark_instruction(arch::addr address)
+	{
+		instructions.set(address);
+	}
+
+	bool analysis_procedure::has_instruction(arch::addr address) const
+	{
+		return instructions.test(address);
+	}
+
 	analysis_path& control_flow_context::analyzed_path()
 	{
 		if (inside_procedure())
@@ -66,11 +94,19 @@ namespace chasm::ds
 
 		paths.emplace_back(path_entrypoint);
 
-		visited_entrypoints.insert(path_entrypoint);
+		visited_entrypoints.set(path_entrypoint);
 	}
 
 	void control_flow_context::path_pop()
 	{
+		//
+		// paths pushed inside procedures decode into the procedure instead, so this one is empty for them
+		//
+		const auto& popped = paths.back();
+
+		for (size_t i = 1; i < popped.instructions_count(); ++i)
+			--paths_instructions[static_cast<arch::addr>(popped.addr_start() + i * sizeof(arch::opcode))];
+
 		paths.pop_back();
 	}
 
@@ -87,12 +123,33 @@ namespace chasm::ds
 		callstack.pop();
 	}
 
+	void control_flow_context::instruction_added()
+	{
+		const auto& path = analyzed_path();
+
+		if (path.instructions_count() < 2)
+			return;
+
+		const arch::addr address = path.addr_end() - sizeof(arch::opcode);
+
+		if (inside_procedure())
+		{
+			analyzed_procedure().mark_instruction(address);
+			return;
+		}
+
+		if (address >= paths_instructions.size())
+			paths_instructions.resize(address + 1);
+
+		++paths_instructions[address];
+	}
+
 	bool control_flow_context::was_visited(arch::addr address) const
 	{
 		//
 		// check against known labels and procedures entrypoints
 		//
-		if (visited_entrypoints.contains(address))
+		if (visited_entrypoints.test(address))
 			return true;
 
 		// In the following scenario:
@@ -103,24 +160,14 @@ namespace chasm::ds
 		// 		   jmp @label
 		//
 		// we don't want to queue ".label" path for analysis as it was already analyzed by the main path
-		// however, if the alignement is not the same, that means it was not analyzed yet, so queue it
+		// however, if the alignement is not the same, that means it was not analyzed yet, so queue it.
+		// Only the addresses instructions were decoded at are recorded, which takes care of the alignment.
 		//
 
-		auto path_has_address = [=](const analysis_path& p) -> bool
-		{
-			const bool in_range = address > p.addr_start() && address < p.addr_end();
-			const bool same_alignement = arch::is_aligned(address) == arch::is_aligned(p.addr_start());
-
-			return in_range && same_alignement;
-		};
-
 		if (inside_procedure())
-		{
-			const auto current_proc = callstack.top();
-			return std::ranges::any_of(current_proc.analyzed_paths(), path_has_address);
-		}
+			return callstack.top().has_instruction(address);
 
-		return std::ranges::any_of(paths, path_has_address);
+		return address < paths_instructions.size() && paths_instructions[address] > 0;
 	}
 
 	bool control_flow_context::inside_procedure() const
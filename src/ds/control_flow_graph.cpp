@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <iterator>
+#include <format>
+#include <limits>
+
+#include <chasm/ds/control_flow_graph.hpp>
+#include <chasm/ds/control_flow_context.hpp>
+
+
+namespace chasm::ds
+{
+	namespace
+	{
+		constexpr auto UNDEFINED = std::numeric_limits<control_flow_graph::block_index>::max();
+		constexpr size_t ADDRESS_SPACE = size_t(std::numeric_limits<arch::addr>::max()) + 1;
+	}
+
+	control_flow_graph::control_flow_graph(std::span<const predecoded_opcode> opcodes, arch::addr base, std::span<const arch::addr> roots)
+	{
+		split_blocks(opcodes, base, roots);
+		compute_dominators();
+		find_loops();
+	}
+
+	void control_flow_graph::split_blocks(std::span<const predecoded_opcode> opcodes, arch::addr base, std::span<const arch::addr> roots)
+	{
+		const auto opcode_at = [&](arch::addr address) -> const predecoded_opcode&
+		{
+			return opcodes[size_t(address) - base];
+		};
+
+		const auto decodes = [&](size_t address)
+		{
+			return address >= base
+				&& address - base + 1 < opcodes.size()
+				&& opcodes[address - base].info.flow != flow_type::invalid;
+		};
+
+		address_bitmap visited;
+		address_bitmap leaders;
+		std::vector<arch::addr> worklist;
+		std::vector<arch::addr> starts;
+		std::vector<arch::addr> root_addresses;
+
+		const auto follow = [&](size_t address, bool leader)
+		{
+			if (address >= ADDRESS_SPACE)
+				return;
+
+			if (leader)
+				leaders.set(static_cast<arch::addr>(address));
+
+			worklist.push_back(static_cast<arch::addr>(address));
+		};
+
+		//
+		// Finds the instructions reached from the roots and marks where blocks have to start
+		//
+		std::vector<arch::addr> instructions;
+
+		for (const auto root : roots)
+		{
+			if (visited.test(root) || !decodes(root))
+				continue;
+
+			root_addresses.push_back(root);
+			follow(root, true);
+
+			while (!worklist.empty())
+			{
+				const auto address = worklist.back();
+				worklist.pop_back();
+
+				if (visited.test(address) || !decodes(address))
+					continue;
+
+				visited.set(address);
+				instructions.push_back(address);
+
+				const auto& [opcode, info] = opcode_at(address);
+
+				switch (info.flow)
+				{
+					case flow_type::next:
+					case flow_type::call:
+						follow(address + sizeof(arch::opcode), false);
+						break;
+
+					case flow_type::skip:
+					case flow_type::fork:
+						follow(address + sizeof(arch::opcode), true);
+						follow(address + 2 * sizeof(arch::opcode), true);
+						break;
+
+					case flow_type::jump:
+						follow(arch::dec::NNN(opcode), true);
+						break;
+
+					default:
+						break;
+				}
+			}
+		}
+
+		for (const auto address : instructions)
+			if (leaders.test(address))
+				starts.push_back(address);
+
+		std::ranges::sort(starts);
+
+		//
+		// A block goes on until an instruction branching or ending, or until the next instruction
+		// starts another block or was not reached
+		//
+		const auto goes_on = [&](arch::addr last)
+		{
+			const auto flow = opcode_at(last).info.flow;
+			const size_t next = last + sizeof(arch::opcode);
+
+			return (flow == flow_type::next || flow == flow_type::call)
+				&& next < ADDRESS_SPACE
+				&& visited.test(static_cast<arch::addr>(next))
+				&& !leaders.test(static_cast<arch::addr>(next));
+		};
+
+		basic_blocks.reserve(starts.size());
+
+		for (const auto start : starts)
+		{
+			auto last = start;
+
+			while (goes_on(last))
+				last = static_cast<arch::addr>(last + sizeof(arch::opcode));
+
+			basic_blocks.push_back({ start, static_cast<arch::addr>(last + sizeof(arch::opcode)), {}, {} });
+		}
+
+		const auto link = [&](block_index from, size_t to)
+		{
+			if (to >= ADDRESS_SPACE)
+				return;
+
+			if (const auto successor = block_at(static_cast<arch::addr>(to)))
+				basic_blocks[from].successors.push_back(*successor);
+		};
+
+		for (block_index b = 0; b < basic_blocks.size(); ++b)
+		{
+			const auto last = static_cast<arch::addr>(basic_blocks[b].end - sizeof(arch::opcode));
+			const auto& [opcode, info] = opcode_at(last);
+
+			switch (info.flow)
+			{
+				case flow_type::next:
+				case flow_type::call:
+					link(b, last + sizeof(arch::opcode));
+					break;
+
+				case flow_type::skip:
+				case flow_type::fork:
+					link(b, last + sizeof(arch::opcode));
+					link(b, last + 2 * sizeof(arch::opcode));
+					break;
+
+				case flow_type::jump:
+					link(b, arch::dec::NNN(opcode));
+					break;
+
+				default:
+					break;
+			}
+
+			for (const auto successor : basic_blocks[b].successors)
+				basic_blocks[successor].predecessors.push_back(b);
+		}
+
+		for (const auto root : root_addresses)
+			root_blocks.push_back(*block_at(root));
+	}
+
+	void control_flow_graph::compute_dominators()
+	{
+		const auto count = static_cast<block_index>(basic_blocks.size());
+
+		//
+		// a virtual block preceding every root, so several roots have a common dominator
+		//
+		const block_index virtual_root = count;
+
+		std::vector<bool> is_root(count + 1, false);
+
+		for (const auto root : root_blocks)
+			is_root[root] = true;
+
+		const auto successors = [&](block_index block) -> std::span<const block_index>
+		{
+			return block == virtual_root ? std::span<const block_index>(root_blocks) : basic_blocks[block].successors;
+		};
+
+		//
+		// Postorder numbers from a depth first search, with an explicit stack as the graph can be deep
+		//
+		std::vector<block_index> postorder_number(count + 1, UNDEFINED);
+		std::vector<block_index> postorder;
+		std::vector<bool> seen(count + 1, false);
+		std::vector<std::pair<block_index, size_t>> stack { { virtual_root, 0 } };
+
+		seen[virtual_root] = true;
+
+		while (!stack.empty())
+		{
+			const auto [block, next] = stack.back();
+			const auto next_blocks = successors(block);
+
+			if (next < next_blocks.size())
+			{
+				++stack.back().second;
+
+				if (const auto successor = next_blocks[next]; !seen[successor])
+				{
+					seen[successor] = true;
+					stack.emplace_back(successor, 0);
+				}
+			}
+			else
+			{
+				postorder_number[block] = static_cast<block_index>(postorder.size());
+				postorder.push_back(block);
+				stack.pop_back();
+			}
+		}
+
+		std::vector<block_index> idom(count + 1, UNDEFINED);
+		idom[virtual_root] = virtual_root;
+
+		const auto intersect = [&](block_index a, block_index b)
+		{
+			while (a != b)
+			{
+				while (postorder_number[a] < postorder_number[b])
+					a = idom[a];
+
+				while (postorder_number[b] < postorder_number[a])
+					b = idom[b];
+			}
+
+			return a;
+		};
+
+		for (bool changed = true; changed; )
+		{
+			changed = false;
+
+			//
+			// reverse postorder, the virtual root coming first is skipped
+			//
+			for (auto it = std::next(postorder.rbegin()); it != postorder.rend(); ++it)
+			{
+				const auto block = *it;
+				auto new_idom = UNDEFINED;
+
+				const auto consider = [&](block_index predecessor)
+				{
+					if (idom[predecessor] == UNDEFINED)
+						return;
+
+					new_idom = new_idom == UNDEFINED ? predecessor : intersect(predecessor, new_idom);
+				};
+
+				if (is_root[block])
+					consider(virtual_root);
+
+				for (const auto predecessor : basic_blocks[block].predecessors)
+					consider(predecessor);
+
+				if (idom[block] != new_idom)
+				{
+					idom[block] = new_idom;
+					changed = true;
+				}
+			}
+		}
+
+		idoms.resize(count);
+
+		//
+		// blocks only dominated by the virtual root, the roots and the blocks reached from several
+		// of them, are stored as their own dominator
+		//
+		for (block_index block = 0; block < count; ++block)
+			idoms[block] = idom[block] == virtual_root ? block : idom[block];
+	}
+
+	void control_flow_graph::find_loops()
+	{
+		const auto count = static_cast<block_index>(basic_blocks.size());
+
+		depths.assign(count, 0);
+
+		//
+		// the header of the loop a block was last added to, so the marks need no clearing between loops
+		//
+		std::vector<block_index> member_of(count, UNDEFINED);
+		std::vector<block_index> stack;
+
+		for (block_index header = 0; header < count; ++header)
+		{
+			for (const auto predecessor : basic_blocks[header].predecessors)
+				if (dominates(header, predecessor))
+					stack.push_back(predecessor);
+
+			if (stack.empty())
+				continue;
+
+			natural_loop loop { header, { header } };
+			member_of[header] = header;
+
+			//
+			// the body is what reaches a back edge without going through the header
+			//
+			while (!stack.empty())
+			{
+				const auto block = stack.back();
+				stack.pop_back();
+
+				if (member_of[block] == header)
+					continue;
+
+				member_of[block] = header;
+				loop.blocks.push_back(block);
+
+				for (const auto predecessor : basic_blocks[block].predecessors)
+					if (member_of[predecessor] != header)
+						stack.push_back(predecessor);
+			}
+
+			std::ranges::sort(loop.blocks);
+
+			for (const auto block : loop.blocks)
+				++depths[block];
+
+			natural_loops.push_back(std::move(loop));
+		}
+	}
+
+	std::span<const control_flow_graph::basic_block> control_flow_graph::blocks() const&
+	{
+		return basic_blocks;
+	}
+
+	std::span<const control_flow_graph::block_index> control_flow_graph::roots() const&
+	{
+		return root_blocks;
+	}
+
+	std::span<const control_flow_graph::natural_loop> control_flow_graph::loops() const&
+	{
+		return natural_loops;
+	}
+
+	std::optional<control_flow_graph::block_index> control_flow_graph::immediate_dominator(block_index block) const
+	{
+		if (idoms[block] == block)
+			return std::nullopt;
+
+		return idoms[block];
+	}
+
+	bool control_flow_graph::dominates(block_index dominator, block_index block) const
+	{
+		for (;;)
+		{
+			if (block == dominator)
+				return true;
+
+			if (idoms[block] == block)
+				return false;
+
+			block = idoms[block];
+		}
+	}
+
+	size_t control_flow_graph::loop_depth(block_index block) const
+	{
+		return depths[block];
+	}
+
+	bool control_flow_graph::is_loop_header(block_index block) const
+	{
+		return std::ranges::binary_search(natural_loops, block, {}, &natural_loop::header);
+	}
+
+	std::optional<control_flow_graph::block_index> control_flow_graph::block_at(arch::addr start) const
+	{
+		const auto at = std::ranges::lower_bound(basic_blocks, start, {}, &basic_block::start);
+
+		if (at == basic_blocks.end() || at->start != start)
+			return std::nullopt;
+
+		return static_cast<block_index>(at - basic_blocks.begin());
+	}
+
+	std::optional<control_flow_graph::block_index> control_flow_graph::block_containing(arch::addr address) const
+	{
+		const auto after = std::ranges::upper_bound(basic_blocks, address, {}, &basic_block::start);
+
+		if (after == basic_blocks.begin() || std::prev(after)->end <= address)
+			return std::nullopt;
+
+		return static_cast<block_index>(std::prev(after) - basic_blocks.begin());
+	}
+
+	program_flow build_program_flow(std::span<const predecoded_opcode> opcodes, arch::addr base, arch::addr entry, const disassembly_graph& graph)
+	{
+		//
+		// the paths outside of procedures the entry point does not reach were found from other seeds
+		//
+		std::vector<arch::addr> roots { entry };
+
+		for (const auto& p : graph.get_paths())
+			roots.push_back(p.addr_start());
+
+		program_flow flow { control_flow_graph(opcodes, base, roots), {} };
+
+		flow.procedures.reserve(graph.get_procedures().size());
+
+		for (const auto& proc : graph.get_procedures())
+		{
+			const arch::addr entrypoint = proc.entrypoint();
+			flow.procedures.emplace_back(opcodes, base, std::span(&entrypoint, 1));
+		}
+
+		return flow;
+	}
+
+	std::string export_dot(const program_flow& flow)
+	{
+		std::string dot = "digraph chasm\n{\n\tnode [shape=box, fontname=monospace];\n";
+		auto out = std::back_inserter(dot);
+
+		const auto cluster = [&](const control_flow_graph& cfg, std::string_view name, size_t id)
+		{
+			std::format_to(out, "\tsubgraph cluster_{}\n\t{{\n\t\tlabel=\"{}\";\n", id, name);
+
+			const auto blocks = cfg.blocks();
+
+			for (control_flow_graph::block_index b = 0; b < blocks.size(); ++b)
+				std::format_to(out, "\t\tf{}_{} [label=\"0x{:04X}..0x{:04X}\"{}];\n",
+							   id, b, blocks[b].start, blocks[b].end, cfg.is_loop_header(b) ? ", peripheries=2" : "");
+
+			for (control_flow_graph::block_index b = 0; b < blocks.size(); ++b)
+				for (const auto successor : blocks[b].successors)
+					std::format_to(out, "\t\tf{0}_{1} -> f{0}_{2};\n", id, b, successor);
+
+			for (control_flow_graph::block_index b = 0; b < blocks.size(); ++b)
+				if (const auto idom = cfg.immediate_dominator(b))
+					std::format_to(out, "\t\tf{0}_{1} -> f{0}_{2} [style=dashed, color=gray, constraint=false];\n", id, *idom, b);
+
+			dot += "\t}\n";
+		};
+
+		cluster(flow.entry, "main", 0);
+
+		for (size_t i = 0; i < flow.procedures.size(); ++i)
+		{
+			const auto& cfg = flow.procedures[i];
+			const auto name = cfg.roots().empty() ? std::string("sub") : std::format("sub_{:04X}", cfg.blocks()[cfg.roots().front()].start);
+
+			cluster(cfg, name, i + 1);
+		}
+
+		dot += "}\n";
+
+		return dot;
+	}
+}
@@ -0,0 +1,141 @@
+#include <chasm/ds/decode_table.hpp>
+
+
+namespace chasm::ds
+{
+	namespace
+	{
+		constexpr opcode_info INVALID = { 0, 0, flow_type::invalid };
+
+		constexpr opcode_info make_info(arch::instruction_id id, arch::operands_mask mask, flow_type flow = flow_type::next)
+		{
+			return { static_cast<uint16_t>(mask), static_cast<uint8_t>(id), flow };
+		}
+
+		constexpr opcode_info decode_opcode(arch::opcode opcode)
+		{
+			const auto n4 = arch::dec::N(opcode);
+			const auto imm8 = arch::dec::NN(opcode);
+
+			switch (opcode >> 12)
+			{
+				case 0x0:
+					switch (opcode)
+					{
+						case 0x00E0: return make_info(arch::CLS, arch::MASK_NONE);
+						case 0x00EE: return make_info(arch::RET, arch::MASK_NONE, flow_type::end);
+						case 0x00FB: return make_info(arch::SCRR, arch::MASK_NONE);
+						case 0x00FC: return make_info(arch::SCRL, arch::MASK_NONE);
+						case 0x00FD: return make_info(arch::EXIT, arch::MASK_NONE, flow_type::end);
+						case 0x00FE: return make_info(arch::LOW, arch::MASK_NONE);
+						case 0x00FF: return make_info(arch::HIGH, arch::MASK_NONE);
+
+						default:
+							if ((opcode & 0xFFF0) == 0x00C0)
+								return make_info(arch::SCRD, arch::MASK_IMM);
+
+							return INVALID;
+					}
+
+				case 0x1: return make_info(arch::JMP, arch::MASK_ADDR, flow_type::jump);
+				case 0x2: return make_info(arch::CALL, arch::MASK_ADDR, flow_type::call);
+				case 0x3: return make_info(arch::SE, arch::MASK_R8_IMM, flow_type::fork);
+				case 0x4: return make_info(arch::SNE, arch::MASK_R8_IMM, flow_type::skip);
+				case 0x5: return n4 == 0 ? make_info(arch::SE, arch::MASK_R8_R8, flow_type::skip) : INVALID;
+				case 0x6: return make_info(arch::MOV, arch::MASK_R8_IMM);
+				case 0x7: return imm8 == 1 ? make_info(arch::INC, arch::MASK_R8) : make_info(arch::ADD, arch::MASK_R8_IMM);
+
+				case 0x8:
+					switch (n4)
+					{
+						case 0x0: return make_info(arch::MOV, arch::MASK_R8_R8);
+						case 0x1: return make_info(arch::OR, arch::MASK_R8_R8);
+						case 0x2: return make_info(arch::AND, arch::MASK_R8_R8);
+						case 0x3: return make_info(arch::XOR, arch::MASK_R8_R8);
+						case 0x4: return make_info(arch::ADD, arch::MASK_R8_R8);
+						case 0x5: return make_info(arch::SUB, arch::MASK_R8_R8);
+						case 0x6: return make_info(arch::SHR, arch::MASK_R8_R8);
+						case 0x7: return make_info(arch::SUBA, arch::MASK_R8_R8);
+						case 0xE: return make_info(arch::SHL, arch::MASK_R8_R8);
+
+						default: return INVALID;
+					}
+
+				case 0x9: return n4 == 0 ? make_info(arch::SNE, arch::MASK_R8_R8, flow_type::skip) : INVALID;
+				case 0xA: return make_info(arch::MOV, arch::MASK_AR_ADDR);
+				case 0xB: return make_info(arch::JMP, arch::MASK_ADDR_REL, flow_type::end);
+				case 0xC: return make_info(arch::RAND, arch::MASK_R8_IMM);
+				case 0xD: return make_info(arch::DRAW, arch::MASK_R8_R8_IMM);
+
+				case 0xE:
+					switch (imm8)
+					{
+						case 0x9E: return make_info(arch::SKE, arch::MASK_R8, flow_type::skip);
+						case 0xA1: return make_info(arch::SKNE, arch::MASK_R8, flow_type::skip);
+
+						default: return INVALID;
+					}
+
+				case 0xF:
+					switch (imm8)
+					{
+						case 0x07: return make_info(arch::MOV, arch::MASK_R8_DT);
+						case 0x0A: return make_info(arch::WKEY, arch::MASK_R8);
+						case 0x15: return make_info(arch::MOV, arch::MASK_DT_R8);
+						case 0x18: return make_info(arch::MOV, arch::MASK_ST_R8);
+						case 0x1E: return make_info(arch::ADD, arch::MASK_AR_R8);
+						case 0x29: return make_info(arch::LDF, arch::MASK_R8);
+						case 0x30: return make_info(arch::LDFS, arch::MASK_R8);
+						case 0x33: return make_info(arch::BCD, arch::MASK_R8);
+						case 0x55: return make_info(arch::RDUMP, arch::MASK_R8);
+						case 0x65: return make_info(arch::RLOAD, arch::MASK_R8);
+						case 0x75: return make_info(arch::SAVERPL, arch::MASK_R8);
+						case 0x85: return make_info(arch::LOADRPL, arch::MASK_R8);
+
+						default: return INVALID;
+					}
+
+				default:
+					return INVALID;
+			}
+		}
+
+		constexpr std::array<opcode_info, 0x10000> make_decode_table()
+		{
+			std::array<opcode_info, 0x10000> table {};
+
+			for (size_t opcode = 0; opcode < table.size(); ++opcode)
+				table[opcode] = decode_opcode(static_cast<arch::opcode>(opcode));
+
+			return table;
+		}
+
+		//
+		// the opcodes the generator encodes have to decode back to the instruction they were encoded from
+		//
+		static_assert(decode_opcode(arch::enc::_00CN(0x3)).id == arch::SCRD);
+		static_assert(decode_opcode(arch::enc::_7XNN(0x3, 1)).id == arch::INC);
+		static_assert(decode_opcode(arch::enc::_8XY6(0x1, 0x2)).id == arch::SHR);
+		static_assert(decode_opcode(arch::enc::_8XYE(0x1, 0x2)).id == arch::SHL);
+		static_assert(decode_opcode(arch::enc::_FX0A(0x4)).id == arch::WKEY);
+		static_assert(decode_opcode(arch::enc::_FX33(0x4)).id == arch::BCD);
+		static_assert(decode_opcode(0x9121).flow == flow_type::invalid);
+		static_assert(decode_opcode(0xE107).flow == flow_type::invalid);
+		static_assert(decode_opcode(0x01C3).flow == flow_type::invalid);
+	}
+
+	constinit const std::array<opcode_info, 0x10000> decode_table = make_decode_table();
+
+	std::vector<predecoded_opcode> predecode(std::span<const uint8_t> bytes)
+	{
+		std::vector<predecoded_opcode> decoded(bytes.size());
+
+		for (size_t offset = 0; offset + 1 < bytes.size(); ++offset)
+		{
+			const auto opcode = static_cast<arch::opcode>(bytes[offset] << 8 | bytes[offset + 1]);
+			decoded[offset] = { opcode, decode_table[opcode] };
+		}
+
+		return decoded;
+	}
+}
@@ -1,18 +1,66 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include <chasm/ds/disassembler.hpp>
+#include <chasm/ds/linear_sweep.hpp>
 #include <chasm/ds/paths.hpp>
+#include <chasm/work_stealing_pool.hpp>
 #include <chasm/options.hpp>
 #include <chasm/arch.hpp>
 
 
 namespace chasm::ds
 {
-	disassembler::disassembler(std::vector<uint8_t> from_bytes, arch::addr from_addr)
-		: binary(std::move(from_bytes))
+	std::optional<disassembly_mode> parse_disassembly_mode(std::string_view name)
+	{
+		if (name == "recursive")
+			return disassembly_mode::recursive;
+
+		if (name == "linear")
+			return disassembly_mode::linear;
+
+		if (name == "hybrid")
+			return disassembly_mode::hybrid;
+
+		return std::nullopt;
+	}
+
+	disassembler::disassembler(std::vector<uint8_t> from_bytes, arch::addr from_addr, disassembly_mode mode, unsigned int threads)
+		: decoded(predecode(from_bytes))
+		, opcodes(decoded)
+		, base(options::arg<arch::addr>("relocate"))
+		, track_claims(mode == disassembly_mode::hybrid)
+	{
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		if (mode == disassembly_mode::linear)
+			ds_linear();
+		else if (threads > 1)
+			ds_parallel(from_addr, threads);
+		else
+			ds_recursive(from_addr);
+
+		if (mode == disassembly_mode::hybrid)
+			ds_hybrid();
+
+		ds_graph.finalize();
+	}
+
+	disassembler::disassembler(std::span<const predecoded_opcode> from_opcodes,
+							   arch::addr from_base,
+							   arch::addr procedure_entry,
+							   bool claims)
+		: opcodes(from_opcodes)
+		, base(from_base)
+		, track_claims(claims)
+		, defer_calls(true)
 	{
-		flow.path_push(from_addr);
-		ds_path();
-		ds_graph.insert_path(current_path());
-		flow.path_pop();
+		worklist.push_back({ task_type::leave_procedure });
+		worklist.push_back({ task_type::enter_procedure, procedure_entry });
+
+		run();
 	}
 
 	analysis_path& disassembler::current_path()
@@ -20,400 +68,363 @@ namespace chasm::ds
 		return flow.analyzed_path();
 	}
 
-	disassembly_graph disassembler::get_graph()
+	const disassembly_graph& disassembler::get_graph() const&
 	{
 		return ds_graph;
 	}
 
-	void disassembler::ds_path()
+	disassembly_graph disassembler::get_graph() &&
 	{
-		while (!current_path().ended())
-			ds_next_instruction();
+		return std::move(ds_graph);
 	}
 
-	void disassembler::ds_next_instruction()
+	std::span<const predecoded_opcode> disassembler::get_opcodes() const&
 	{
-		///
-		/// The paths manager only manipulates "in-memory" addresses, most of the time offset=0x200
-		/// whereas the disassembler works with "disk" addresses, so offset 0x200 maps to address (file offset) 0 on disk
-		///
-		const arch::addr ip = current_path().addr_end() - options::arg<arch::addr>("relocate");
-
-		if (ip + 1 >= binary.size() || ip >= binary.size())
-			throw chasm_exception("Unexpected end of bytes while decoding instruction during disassembly at address 0x{:04X}", ip);
-
-		const auto opcode = static_cast<arch::opcode>(binary[ip] << 8 | binary[ip + 1]);
-
-		const auto n1 = static_cast<uint8_t>((opcode & 0xF000) >> 12);
-		const auto n2 = static_cast<uint8_t>((opcode & 0x0F00) >> 8);
-		const auto n3 = static_cast<uint8_t>((opcode & 0x00F0) >> 4);
-		const auto n4 = static_cast<uint8_t>(opcode & 0x000F);
-		const auto imm8 = static_cast<arch::imm>(opcode & 0x00FF);
-		const auto addr = static_cast<arch::addr>(opcode & 0x0FFF);
-
-		switch (n1)
-		{
-			case 0x0:
-			{
-				switch (opcode)
-				{
-					case 0x00E0: ds_cls(); return;
-					case 0x00EE: ds_ret(); return;
-					case 0x00FB: ds_scrr(); return;
-					case 0x00FC: ds_scrl(); return;
-					case 0x00FD: ds_exit(); return;
-					case 0x00FE: ds_low(); return;
-					case 0x00FF: ds_high(); return;
-
-					default:
-					{
-						if (n3 == 0xC)
-						{
-							ds_scrd();
-							return;
-						}
-					}
-				}
+		return opcodes;
+	}
 
-				break;
-			}
+	void disassembler::ds_recursive(arch::addr from_addr)
+	{
+		worklist.push_back({ task_type::leave_path });
+		worklist.push_back({ task_type::enter_path, from_addr });
 
-			case 0x1: ds_jmp(addr); return;
-			case 0x2: ds_call(addr); return;
-			case 0xA: ds_mov_ar_addr(addr); return;
-			case 0xB: ds_jmp_indirect(addr); return;
+		run();
 
-			case 0x3: ds_se_r8_imm(n2, imm8); return;
-			case 0x4: ds_sne_r8_imm(n2, imm8); return;
-			case 0x6: ds_mov_r8_imm(n2, imm8); return;
-			case 0x7: ds_add_r8_imm(n2, imm8); return;
-			case 0xC: ds_rand_r8_imm(n2, imm8); return;
+		for (const auto address : fresh_instructions)
+			claimed_instructions.set(address);
 
-			case 0x5:
-				if (n4 == 0)
-				{
-					ds_se_r8_r8(n2, n3);
-					return;
-				}
+		fresh_instructions.clear();
+	}
 
-				break;
+	void disassembler::ds_parallel(arch::addr from_addr, unsigned int threads)
+	{
+		struct procedure_analysis
+		{
+			disassembly_graph analyzed;
+			std::vector<arch::addr> starts;
+			std::vector<arch::addr> instructions;
+		};
 
-			case 0x8:
-				switch (n4)
-				{
-					case 0x0: ds_mov_r8_r8(n2, n3); return;
-					case 0x1: ds_or_r8_r8(n2, n3); return;
-					case 0x2: ds_and_r8_r8(n2, n3); return;
-					case 0x3: ds_xor_r8_r8(n2, n3); return;
-					case 0x4: ds_add_r8_r8(n2, n3); return;
-					case 0x5: ds_sub_r8_r8(n2, n3); return;
-					case 0x6: ds_shl_r8_r8(n2, n3); return;
-					case 0x7: ds_suba_r8_r8(n2, n3); return;
-					case 0xE: ds_shr_r8_r8(n2, n3); return;
-
-					default: break;
-				}
+		//
+		// one bit per address, set by the first analysis calling the procedure there
+		//
+		std::vector<std::atomic<uint64_t>> entrypoints(0x10000 / 64);
 
-				break;
+		const auto claim = [&](arch::addr entry)
+		{
+			const auto bit = uint64_t(1) << (entry % 64);
+			return (entrypoints[entry / 64].fetch_or(bit) & bit) == 0;
+		};
 
-			case 0x9:
-				if (n4 == 0)
-				{
-					ds_sne_r8_r8(n2, n3);
-					return;
-				}
+		std::vector<std::vector<procedure_analysis>> analyses(threads);
 
-			case 0xE:
-				if (imm8 == 0x9E)
-				{
-					ds_ske_r8(n2);
-					return;
-				}
-				else if (imm8 == 0xA1)
-				{
-					ds_skne_r8(n2);
-					return;
-				}
+		try
+		{
+			defer_calls = true;
+			ds_recursive(from_addr);
+			defer_calls = false;
 
-			case 0xF:
-				switch (imm8)
-				{
-					case 0x07: ds_mov_r8_dt(n2); return;
-					case 0x15: ds_mov_dt_r8(n2); return;
-					case 0x18: ds_mov_st_r8(n2); return;
-					case 0x1E: ds_add_ar_r8(n2); return;
-					case 0x29: ds_ldf_r8(n2); return;
-					case 0x30: ds_ldfs_r8(n2); return;
-					case 0x55: ds_rdump_r8(n2); return;
-					case 0x65: ds_rload_r8(n2); return;
-					case 0x75: ds_saverpl_r8(n2); return;
-					case 0x85: ds_loadrpl_r8(n2); return;
-
-					default: break;
-				}
+			std::vector<arch::addr> seeds;
 
-				break;
+			for (const auto entry : deferred_calls)
+				if (claim(entry))
+					seeds.push_back(entry);
 
-			case 0xD: ds_draw_r8_r8_imm(n2, n3, n4); return;
+			work_stealing_pool<arch::addr> pool(threads);
 
-			default:
-				break;
+			pool.run(std::move(seeds), [&](arch::addr entry, size_t worker, const auto& spawn)
+			{
+				disassembler analysis(opcodes, base, entry, track_claims);
+
+				for (const auto call : analysis.deferred_calls)
+					if (claim(call))
+						spawn(call);
+
+				analyses[worker].push_back({
+					std::move(analysis.ds_graph),
+					std::move(analysis.path_starts),
+					std::move(analysis.fresh_instructions)
+				});
+			});
+		}
+		catch (const chasm_exception&)
+		{
+			//
+			// the serial traversal reports the error it runs into first
+			//
+			reset();
+			return ds_recursive(from_addr);
 		}
 
-		throw disassembly_exception::decoding_error(opcode, ip);
-	}
+		//
+		// A path started by two analyses means the serial traversal would have seen it already
+		// decoded by one of them when reaching it from the other, and left it out there
+		//
+		std::vector<std::pair<arch::addr, size_t>> starts;
 
-	void disassembler::ds_cls()
-	{
-		emit(arch::instruction_id::CLS, arch::operands_mask::MASK_NONE);
-	}
+		for (const auto start : path_starts)
+			starts.emplace_back(start, 0);
 
-	void disassembler::ds_ret()
-	{
-		emit(arch::instruction_id::RET, arch::operands_mask::MASK_NONE);
+		size_t owner = 0;
 
-		current_path().mark_end();
-	}
+		for (const auto& worker : analyses)
+			for (const auto& analysis : worker)
+			{
+				++owner;
 
-	void disassembler::ds_scrr()
-	{
-		emit(arch::instruction_id::SCRR, arch::operands_mask::MASK_NONE);
-	}
+				for (const auto start : analysis.starts)
+					starts.emplace_back(start, owner);
+			}
 
-	void disassembler::ds_scrl()
-	{
-		emit(arch::instruction_id::SCRL, arch::operands_mask::MASK_NONE);
-	}
+		std::ranges::sort(starts);
 
-	void disassembler::ds_exit()
-	{
-		emit(arch::instruction_id::EXIT, arch::operands_mask::MASK_NONE);
+		const auto shared = std::ranges::adjacent_find(starts, [](const auto& a, const auto& b)
+		{
+			return a.first == b.first && a.second != b.second;
+		});
 
-		current_path().mark_end();
-	}
+		if (shared != starts.end())
+		{
+			reset();
+			return ds_recursive(from_addr);
+		}
 
-	void disassembler::ds_low()
-	{
-		emit(arch::instruction_id::LOW, arch::operands_mask::MASK_NONE);
-	}
+		for (auto& worker : analyses)
+			for (auto& analysis : worker)
+			{
+				ds_graph.merge(std::move(analysis.analyzed));
 
-	void disassembler::ds_high()
-	{
-		emit(arch::instruction_id::HIGH, arch::operands_mask::MASK_NONE);
+				for (const auto address : analysis.instructions)
+					claimed_instructions.set(address);
+			}
 	}
 
-	void disassembler::ds_scrd()
+	void disassembler::reset()
 	{
-		emit(arch::instruction_id::SCRD, arch::operands_mask::MASK_NONE);
+		flow = {};
+		ds_graph = {};
+		worklist.clear();
+		fresh_instructions.clear();
+		claimed_instructions = {};
+		defer_calls = false;
+		deferred_calls.clear();
+		path_starts.clear();
 	}
 
-	void disassembler::ds_call(arch::addr subroutine_addr)
+	void disassembler::ds_linear()
 	{
-		emit(arch::instruction_id::CALL, arch::operands_mask::MASK_ADDR, subroutine_addr);
+		for (const auto& code : linear_sweep(opcodes))
+		{
+			path p(static_cast<arch::addr>(base + code.offset));
 
-		if (flow.was_visited(subroutine_addr))
-			return;
+			for (size_t i = 0; i < code.instructions; ++i)
+			{
+				const auto& [opcode, info] = opcodes[code.offset + i * sizeof(arch::opcode)];
+				p.add_instruction(info.instruction(), info.operands(), opcode);
+			}
 
-		flow.callstack_push(subroutine_addr);
-		ds_path();
-		ds_graph.insert_proc(flow.analyzed_procedure().to_procedure());
-		flow.callstack_pop();
+			ds_graph.append_path(std::move(p));
+		}
 	}
 
-	void disassembler::ds_jmp(arch::addr location)
+	void disassembler::ds_hybrid()
 	{
-		emit(arch::instruction_id::JMP, arch::operands_mask::MASK_ADDR, location);
-
-		current_path().mark_end();
-
-		if (flow.was_visited(location))
-			return;
+		speculative = true;
 
-		flow.path_push(location);
-		ds_path();
+		for (const auto& code : linear_sweep(opcodes))
+		{
+			if (!code.terminated)
+				continue;
+
+			//
+			// the traversal from an address stops wherever it runs into code already decoded, so the
+			// rest of the run is only traversed from the instructions that are still left
+			//
+			for (size_t i = 0; i < code.instructions; ++i)
+			{
+				const auto address = static_cast<arch::addr>(base + code.offset + i * sizeof(arch::opcode));
 
-		if (!flow.inside_procedure())
-			ds_graph.insert_path(current_path());
+				if (!claimed_instructions.test(address))
+					ds_recursive(address);
+			}
+		}
 
-		flow.path_pop();
+		speculative = false;
 	}
 
-	void disassembler::ds_mov_ar_addr(arch::addr addr)
+	bool disassembler::stops_at(arch::addr address) const
 	{
-		emit(arch::instruction_id::MOV, arch::operands_mask::MASK_AR_ADDR, addr);
-	}
+		if (claimed_instructions.test(address))
+			return true;
 
-	void disassembler::ds_jmp_indirect(arch::addr offset)
-	{
-		emit(arch::instruction_id::JMP, arch::operands_mask::MASK_ADDR_REL, offset);
+		const arch::addr offset = address - base;
 
-		current_path().mark_end();
+		return speculative && (offset >= opcodes.size() || opcodes[offset].info.flow == flow_type::invalid);
 	}
 
-	void disassembler::ds_se_r8_imm(arch::reg reg, arch::imm imm)
+	void disassembler::run()
 	{
-		emit(arch::instruction_id::SE, arch::operands_mask::MASK_R8_IMM, reg, imm);
-
-		const arch::addr next1 = current_path().addr_end();
-		const arch::addr next2 = current_path().addr_end() + sizeof(arch::opcode);
+		while (!worklist.empty())
+		{
+			const auto [type, address] = worklist.back();
+			worklist.pop_back();
 
-		flow.path_push(next1);
-		ds_path();
+			switch (type)
+			{
+				case task_type::resume_path:
+					break;
 
-		if (!flow.inside_procedure())
-			ds_graph.insert_path(current_path());
+				case task_type::enter_path:
+					flow.path_push(address);
 
-		flow.path_pop();
+					if (defer_calls)
+						path_starts.push_back(address);
+					break;
 
-		flow.path_push(next2);
-		ds_path();
+				case task_type::leave_path:
+					if (!flow.inside_procedure())
+						ds_graph.append_path(current_path());
 
-		if (!flow.inside_procedure())
-			ds_graph.insert_path(current_path());
+					flow.path_pop();
+					continue;
 
-		flow.path_pop();
-	}
+				case task_type::enter_procedure:
+					flow.callstack_push(address);
 
-	void disassembler::ds_sne_r8_imm(arch::reg reg, arch::imm imm)
-	{
-		emit(arch::instruction_id::SNE, arch::operands_mask::MASK_R8_IMM, reg, imm);
-	}
+					if (defer_calls)
+						path_starts.push_back(address);
+					break;
 
-	void disassembler::ds_mov_r8_imm(arch::reg reg, arch::imm imm)
-	{
-		emit(arch::instruction_id::MOV, arch::operands_mask::MASK_R8_IMM, reg, imm);
-	}
+				case task_type::leave_procedure:
+					ds_graph.append_proc(flow.analyzed_procedure().to_procedure());
+					flow.callstack_pop();
+					continue;
+			}
 
-	void disassembler::ds_add_r8_imm(arch::reg reg, arch::imm imm)
-	{
-		if (imm == 1)
-			emit(arch::instruction_id::INC, arch::operands_mask::MASK_R8, reg);
-		else
-			emit(arch::instruction_id::ADD, arch::operands_mask::MASK_R8_IMM, reg, imm);
+			ds_path();
+		}
 	}
 
-	void disassembler::ds_rand_r8_imm(arch::reg reg, arch::imm imm)
+	void disassembler::branch(std::initializer_list<task> tasks)
 	{
-		emit(arch::instruction_id::RAND, arch::operands_mask::MASK_R8_IMM, reg, imm);
+		//
+		// the path that branched goes on once the tasks are done, in the given order
+		//
+		worklist.push_back({ task_type::resume_path });
+		worklist.insert(worklist.end(), std::rbegin(tasks), std::rend(tasks));
 	}
 
-	void disassembler::ds_se_r8_r8(arch::reg reg1, arch::reg reg2)
+	void disassembler::ds_path()
 	{
-		emit(arch::instruction_id::SE, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		const auto pending = worklist.size();
 
-	void disassembler::ds_mov_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::MOV, arch::operands_mask::MASK_R8_R8, reg1, reg2);
+		while (!current_path().ended() && worklist.size() == pending)
+			ds_next_instruction();
 	}
 
-	void disassembler::ds_or_r8_r8(arch::reg reg1, arch::reg reg2)
+	void disassembler::ds_next_instruction()
 	{
-		emit(arch::instruction_id::OR, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		///
+		/// The paths manager only manipulates "in-memory" addresses, most of the time offset=0x200
+		/// whereas the disassembler works with "disk" addresses, so offset 0x200 maps to address (file offset) 0 on disk
+		///
+		const arch::addr ip = current_path().addr_end() - base;
 
-	void disassembler::ds_and_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::AND, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		//
+		// falls into code an earlier traversal decoded, which the listing already shows, or into data
+		//
+		if (stops_at(current_path().addr_end()))
+		{
+			current_path().mark_end();
+			return;
+		}
 
-	void disassembler::ds_xor_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::XOR, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		if (ip + 1 >= opcodes.size() || ip >= opcodes.size())
+			throw chasm_exception("Unexpected end of bytes while decoding instruction during disassembly at address 0x{:04X}", ip);
 
-	void disassembler::ds_add_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::ADD, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		const auto& instruction = opcodes[ip];
 
-	void disassembler::ds_sub_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::SUB, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		if (instruction.info.flow == flow_type::invalid)
+			throw disassembly_exception::decoding_error(instruction.opcode, ip);
 
-	void disassembler::ds_shl_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::SHL, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		emit(instruction);
 
-	void disassembler::ds_suba_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::SUBA, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
-
-	void disassembler::ds_shr_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::SHR, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+		switch (instruction.info.flow)
+		{
+			case flow_type::fork:
+				ds_fork();
+				break;
 
-	void disassembler::ds_sne_r8_r8(arch::reg reg1, arch::reg reg2)
-	{
-		emit(arch::instruction_id::SNE, arch::operands_mask::MASK_R8_R8, reg1, reg2);
-	}
+			case flow_type::jump:
+				ds_jmp(arch::dec::NNN(instruction.opcode));
+				break;
 
-	void disassembler::ds_mov_r8_dt(arch::reg reg)
-	{
-		emit(arch::instruction_id::MOV, arch::operands_mask::MASK_R8_DT, reg);
-	}
+			case flow_type::call:
+				ds_call(arch::dec::NNN(instruction.opcode));
+				break;
 
-	void disassembler::ds_mov_dt_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::MOV, arch::operands_mask::MASK_DT_R8, reg);
-	}
+			case flow_type::end:
+				current_path().mark_end();
+				break;
 
-	void disassembler::ds_mov_st_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::MOV, arch::operands_mask::MASK_ST_R8, reg);
+			default:
+				break;
+		}
 	}
 
-	void disassembler::ds_add_ar_r8(arch::reg reg)
+	void disassembler::ds_call(arch::addr subroutine_addr)
 	{
-		emit(arch::instruction_id::ADD, arch::operands_mask::MASK_AR_R8, reg);
-	}
+		if (flow.was_visited(subroutine_addr) || stops_at(subroutine_addr))
+			return;
 
-	void disassembler::ds_ldf_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::LDF, arch::operands_mask::MASK_R8, reg);
-	}
+		if (defer_calls)
+			return deferred_calls.push_back(subroutine_addr);
 
-	void disassembler::ds_ldfs_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::LDFS, arch::operands_mask::MASK_R8, reg);
+		branch({
+			{ task_type::enter_procedure, subroutine_addr },
+			{ task_type::leave_procedure }
+		});
 	}
 
-	void disassembler::ds_rdump_r8(arch::reg reg)
+	void disassembler::ds_jmp(arch::addr location)
 	{
-		emit(arch::instruction_id::RDUMP, arch::operands_mask::MASK_R8, reg);
-	}
+		current_path().mark_end();
 
-	void disassembler::ds_rload_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::RLOAD, arch::operands_mask::MASK_R8, reg);
-	}
+		if (flow.was_visited(location) || stops_at(location))
+			return;
 
-	void disassembler::ds_saverpl_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::SAVERPL, arch::operands_mask::MASK_R8, reg);
+		branch({
+			{ task_type::enter_path, location },
+			{ task_type::leave_path }
+		});
 	}
 
-	void disassembler::ds_loadrpl_r8(arch::reg reg)
+	void disassembler::ds_fork()
 	{
-		emit(arch::instruction_id::LOADRPL, arch::operands_mask::MASK_R8, reg);
-	}
+		const arch::addr next1 = current_path().addr_end();
+		const arch::addr next2 = current_path().addr_end() + sizeof(arch::opcode);
 
-	void disassembler::ds_ske_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::SKE, arch::operands_mask::MASK_R8, reg);
-	}
+		if (stops_at(next1) || stops_at(next2))
+		{
+			for (const auto next : { next1, next2 })
+			{
+				if (!stops_at(next))
+				{
+					branch({
+						{ task_type::enter_path, next },
+						{ task_type::leave_path }
+					});
+				}
+			}
 
-	void disassembler::ds_skne_r8(arch::reg reg)
-	{
-		emit(arch::instruction_id::SKNE, arch::operands_mask::MASK_R8, reg);
-	}
+			return;
+		}
 
-	void disassembler::ds_draw_r8_r8_imm(arch::reg reg1, arch::reg reg2, arch::imm imm)
-	{
-		emit(arch::instruction_id::DRAW, arch::operands_mask::MASK_R8_R8_IMM, reg1, reg2, imm);
+		branch({
+			{ task_type::enter_path, next1 },
+			{ task_type::leave_path },
+			{ task_type::enter_path, next2 },
+			{ task_type::leave_path }
+		});
 	}
 }
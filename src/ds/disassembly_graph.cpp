@@ -1,28 +1,62 @@
-#include <chasm/ds/disassembly_graph.hpp>
+#include <algorithm>
+#include <iterator>
 
+#include <chasm/ds/disassembly_graph.hpp>
 
 
 namespace chasm::ds
 {
 	void disassembly_graph::insert_proc(procedure p)
 	{
-		procedures.insert(std::move(p));
+		insert_sorted(procedures, std::move(p), &procedure::entrypoint);
 	}
 
 	void disassembly_graph::insert_path(path p)
 	{
-		paths.insert(std::move(p));
+		insert_sorted(paths, std::move(p), &path::addr_start);
+	}
+
+	void disassembly_graph::append_proc(procedure p)
+	{
+		procedures.push_back(std::move(p));
 	}
 
-	std::set<procedure> disassembly_graph::get_procedures() const
+	void disassembly_graph::append_path(path p)
+	{
+		paths.push_back(std::move(p));
+	}
+
+	void disassembly_graph::merge(disassembly_graph&& other)
+	{
+		std::ranges::move(other.procedures, std::back_inserter(procedures));
+		std::ranges::move(other.paths, std::back_inserter(paths));
+
+		other = {};
+	}
+
+	void disassembly_graph::finalize()
+	{
+		sort_unique(procedures, &procedure::entrypoint);
+		sort_unique(paths, &path::addr_start);
+	}
+
+	std::span<const procedure> disassembly_graph::get_procedures() const&
 	{
 		return procedures;
 	}
 
-	std::set<path> disassembly_graph::get_paths() const
+	std::span<const path> disassembly_graph::get_paths() const&
 	{
 		return paths;
 	}
-}
 
+	const procedure* disassembly_graph::find_procedure(arch::addr entrypoint) const
+	{
+		return find_sorted(procedures, entrypoint, &procedure::entrypoint);
+	}
 
+	const path* disassembly_graph::find_path(arch::addr start) const
+	{
+		return find_sorted(paths, start, &path::addr_start);
+	}
+}
@@ -1,54 +1,42 @@
 #include <iostream>
 #include <chasm/ds/disassembly_interface.hpp>
+#include <chasm/ds/listing_renderer.hpp>
+#include <chasm/log.hpp>
 
 
 namespace chasm::ds
 {
-	disassembly_interface::disassembly_interface(disassembly_graph&& graph_)
+	disassembly_interface::disassembly_interface(disassembly_graph&& graph_, std::optional<program_flow> flow_)
 		: graph(std::move(graph_))
+		, flow(std::move(flow_))
 	{}
 
 	void disassembly_interface::run()
 	{
+		print_disassembly();
+
 		while (is_running)
 		{
-			print_disassembly();
-
 			std::string cmd;
-			std::cout << '>';
-			std::cin >> cmd;
+			std::cout << '>' << std::flush;
 
-			if (cmd == "exit")
+			if (!(std::cin >> cmd) || cmd == "exit")
 				is_running = false;
+			else if (cmd == "print")
+				print_disassembly();
+			else
+				log::warn("Unknown command \"{}\", expected print or exit", cmd);
 		}
 	}
 
 	void disassembly_interface::print_disassembly() const
 	{
-		const auto procedures = graph.get_procedures();
-
-		for (const auto& proc : procedures)
-		{
-			std::cout << std::format("proc sub_{:04X}", proc.entrypoint()) << std::endl;
-
-			for (const auto& path : proc.get_paths())
-			{
-				if (path.addr_start() != proc.entrypoint())
-					std::cout << std::format(".loc_{:04X}:", path.addr_start()) << std::endl;
-
-				for (size_t i = 0; i < path.instructions_count(); ++i)
-					std::cout << "    " << path.symbolic(i) << std::endl;
-			}
+		//
+		// the listing is rendered into one buffer and written at once, it can be large when piped
+		//
+		const auto listing = render_listing(graph, flow ? &*flow : nullptr);
 
-			std::cout << std::format("endp sub_{:04X}\n", proc.entrypoint()) << std::endl;
-		}
-
-		for (const auto& path : graph.get_paths())
-		{
-			std::cout << std::format(".loc_{:04X}:", path.addr_start()) << std::endl;
-
-			for (size_t i = 0; i < path.instructions_count(); ++i)
-				std::cout << "    " << path.symbolic(i) << std::endl;
-		}
+		std::cout.write(listing.data(), static_cast<std::streamsize>(listing.size()));
+		std::cout.flush();
 	}
-}
\ No newline at end of file
+}
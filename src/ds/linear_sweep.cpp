@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <optional>
+#include <bit>
+
+#include <chasm/ds/linear_sweep.hpp>
+
+
+namespace chasm::ds
+{
+	std::vector<code_run> linear_sweep(std::span<const predecoded_opcode> decoded)
+	{
+		constexpr size_t BLOCK = 64;
+
+		const size_t words = decoded.size() / sizeof(arch::opcode);
+
+		std::vector<code_run> runs;
+		std::optional<size_t> open;
+
+		//
+		// set when the last word of the previous block goes on into the first one of this block
+		//
+		uint64_t carry = 0;
+
+		for (size_t block = 0; block < words; block += BLOCK)
+		{
+			const auto count = std::min(BLOCK, words - block);
+
+			uint64_t valid = 0;
+			uint64_t stop = 0;
+
+			for (size_t k = 0; k < count; ++k)
+			{
+				const auto flow = decoded[(block + k) * sizeof(arch::opcode)].info.flow;
+
+				valid |= uint64_t(flow != flow_type::invalid) << k;
+				stop |= uint64_t(flow == flow_type::jump || flow == flow_type::end) << k;
+			}
+
+			const uint64_t in_block = count == BLOCK ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+			const uint64_t continues = valid & ~stop;
+			const uint64_t starts = valid & ~(continues << 1 | carry);
+
+			carry = continues >> (BLOCK - 1);
+
+			//
+			// only the words starting, terminating or breaking a run are visited
+			//
+			uint64_t events = (starts | stop | ~valid) & in_block;
+
+			while (events != 0)
+			{
+				const auto k = static_cast<size_t>(std::countr_zero(events));
+				const auto bit = uint64_t(1) << k;
+				const auto word = block + k;
+
+				events &= events - 1;
+
+				if (starts & bit)
+					open = word;
+
+				if (stop & bit)
+				{
+					runs.push_back({ *open * sizeof(arch::opcode), word - *open + 1, true });
+					open.reset();
+				}
+				else if ((valid & bit) == 0 && open)
+				{
+					runs.push_back({ *open * sizeof(arch::opcode), word - *open, false });
+					open.reset();
+				}
+			}
+		}
+
+		if (open)
+			runs.push_back({ *open * sizeof(arch::opcode), words - *open, false });
+
+		return runs;
+	}
+}
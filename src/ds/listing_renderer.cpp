@@ -0,0 +1,122 @@
+#include <iterator>
+#include <format>
+
+#include <chasm/ds/listing_renderer.hpp>
+
+
+namespace chasm::ds
+{
+	namespace
+	{
+		//
+		// an indented instruction with its operands and a label line take about that much
+		//
+		constexpr size_t INSTRUCTION_LINE_SIZE = 24;
+		constexpr size_t LABEL_LINE_SIZE = 12;
+
+		template<std::output_iterator<char> OutputIt>
+		OutputIt render_block(OutputIt out, const control_flow_graph& cfg, control_flow_graph::block_index b)
+		{
+			const auto blocks = cfg.blocks();
+
+			out = std::format_to(out, "    ;; block 0x{:04X}", blocks[b].start);
+
+			if (!blocks[b].predecessors.empty())
+			{
+				out = std::format_to(out, ", from");
+
+				for (const auto predecessor : blocks[b].predecessors)
+					out = std::format_to(out, " 0x{:04X}", blocks[predecessor].start);
+			}
+
+			if (const auto idom = cfg.immediate_dominator(b))
+				out = std::format_to(out, ", idom 0x{:04X}", blocks[*idom].start);
+
+			if (cfg.is_loop_header(b))
+				out = std::format_to(out, ", loop header");
+
+			if (const auto depth = cfg.loop_depth(b); depth > 0)
+				out = std::format_to(out, ", loop depth {}", depth);
+
+			*out++ = '\n';
+
+			return out;
+		}
+
+		template<std::output_iterator<char> OutputIt>
+		OutputIt render_instructions(OutputIt out, const path& p, const control_flow_graph* cfg)
+		{
+			for (size_t i = 0; i < p.instructions_count(); ++i)
+			{
+				if (cfg)
+				{
+					const auto address = static_cast<arch::addr>(p.addr_start() + i * sizeof(arch::opcode));
+
+					if (const auto block = cfg->block_at(address))
+						out = render_block(out, *cfg, *block);
+				}
+
+				out = std::format_to(out, "    ");
+				out = p.symbolic_to(out, i);
+				*out++ = '\n';
+			}
+
+			return out;
+		}
+	}
+
+	std::string render_listing(const disassembly_graph& graph, const program_flow* flow)
+	{
+		const auto procedures = graph.get_procedures();
+		const auto paths = graph.get_paths();
+
+		size_t size = 0;
+
+		const auto estimate = [&](const path& p)
+		{
+			size += LABEL_LINE_SIZE + p.instructions_count() * INSTRUCTION_LINE_SIZE;
+		};
+
+		for (const auto& proc : procedures)
+		{
+			size += 2 * LABEL_LINE_SIZE;
+
+			for (const auto& p : proc.get_paths())
+				estimate(p);
+		}
+
+		for (const auto& p : paths)
+			estimate(p);
+
+		std::string listing;
+		listing.reserve(size);
+
+		auto out = std::back_inserter(listing);
+
+		for (size_t i = 0; i < procedures.size(); ++i)
+		{
+			const auto& proc = procedures[i];
+			const auto* const cfg = flow ? &flow->procedures[i] : nullptr;
+
+			out = std::format_to(out, "proc sub_{:04X}\n", proc.entrypoint());
+
+			for (const auto& p : proc.get_paths())
+			{
+				if (p.addr_start() != proc.entrypoint())
+					out = std::format_to(out, ".loc_{:04X}:\n", p.addr_start());
+
+				out = render_instructions(out, p, cfg);
+			}
+
+			out = std::format_to(out, "endp sub_{:04X}\n\n", proc.entrypoint());
+		}
+
+		for (const auto& p : paths)
+		{
+			out = std::format_to(out, ".loc_{:04X}:\n", p.addr_start());
+			out = render_instructions(out, p, flow ? &flow->entry : nullptr);
+		}
+
+		return listing;
+	}
+}
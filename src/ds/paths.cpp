@@ -22,30 +22,59 @@ namespace chasm::ds
 		return disassembly.size();
 	}
 
-	std::string path::symbolic(size_t instruction_index) const
+	void path::add_instruction(arch::instruction_id id, arch::operands_mask mask, arch::opcode opcode)
+	{
+		disassembly.push_back({
+			opcode,
+			static_cast<uint16_t>(mask),
+			static_cast<uint8_t>(id)
+		});
+	}
+
+	const decoded_instruction& path::instruction(size_t instruction_index) const
 	{
 		return disassembly[instruction_index];
 	}
 
+	std::string path::symbolic(size_t instruction_index) const
+	{
+		std::string text;
+		symbolic_to(std::back_inserter(text), instruction_index);
+
+		return text;
+	}
+
 	bool path::operator<(const path &other) const
 	{
 		return addr_start() < other.addr_start();
 	}
 
-	std::set<path> procedure::get_paths() const
+	std::span<const path> procedure::get_paths() const&
 	{
 		return ordered_paths;
 	}
 
+	const path* procedure::find_path(arch::addr start) const
+	{
+		return find_sorted(ordered_paths, start, &path::addr_start);
+	}
+
 	void procedure::insert_path(path p)
 	{
-		ordered_paths.insert(std::move(p));
+		insert_sorted(ordered_paths, std::move(p), &path::addr_start);
 	}
 
 	procedure::procedure(arch::addr ep)
 		: ep(ep)
 	{}
 
+	procedure::procedure(arch::addr ep, std::vector<path>&& paths)
+		: ep(ep)
+		, ordered_paths(std::move(paths))
+	{
+		sort_unique(ordered_paths, &path::addr_start);
+	}
+
 	arch::addr procedure::entrypoint() const
 	{
 		return ep;
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <format>
+#include <vector>
+
+#include <chasm/ds/source_listing.hpp>
+#include <chasm/ds/formatter.hpp>
+
+
+namespace chasm::ds
+{
+	namespace
+	{
+		enum class label_kind : uint8_t
+		{
+			none,
+			location,
+			procedure
+		};
+
+		std::string label_name(label_kind kind, size_t offset, arch::addr base)
+		{
+			if (offset == 0)
+				return "main";
+
+			const auto address = base + offset;
+
+			return kind == label_kind::procedure ? std::format("sub_{:04X}", address) : std::format("loc_{:04X}", address);
+		}
+	}
+
+	std::string render_source(std::span<const uint8_t> rom, arch::addr base, const disassembly_graph& graph)
+	{
+		const auto offset_of = [&](arch::addr address) -> std::optional<size_t>
+		{
+			if (address < base || address - base >= rom.size())
+				return std::nullopt;
+
+			return address - base;
+		};
+
+		std::vector<std::optional<decoded_instruction>> instructions(rom.size());
+		std::vector<label_kind> labels(rom.size(), label_kind::none);
+
+		const auto add_label = [&](arch::addr address, label_kind kind)
+		{
+			if (const auto offset = offset_of(address))
+				labels[*offset] = std::max(labels[*offset], kind);
+		};
+
+		const auto add_path = [&](const path& p)
+		{
+			add_label(p.addr_start(), label_kind::location);
+
+			for (size_t i = 0; i < p.instructions_count(); ++i)
+			{
+				const auto offset = offset_of(static_cast<arch::addr>(p.addr_start() + i * sizeof(arch::opcode)));
+
+				if (offset && *offset + 1 < rom.size())
+					instructions[*offset] = p.instruction(i);
+			}
+		};
+
+		for (const auto& proc : graph.get_procedures())
+		{
+			for (const auto& p : proc.get_paths())
+				add_path(p);
+
+			add_label(proc.entrypoint(), label_kind::procedure);
+		}
+
+		for (const auto& p : graph.get_paths())
+			add_path(p);
+
+		//
+		// In ROM order, an instruction starting in the middle of the one before it is dropped, its
+		// bytes are already written. Nothing can be labeled there.
+		//
+		std::vector<bool> starts(rom.size(), true);
+
+		for (size_t offset = 0; offset < rom.size(); ++offset)
+		{
+			if (!starts[offset] || !instructions[offset])
+				continue;
+
+			starts[offset + 1] = false;
+			instructions[offset + 1].reset();
+			labels[offset + 1] = label_kind::none;
+		}
+
+		const auto jump_label = [&](arch::addr target) -> std::optional<std::string>
+		{
+			const auto offset = offset_of(target);
+
+			if (!offset || !starts[*offset])
+				return std::nullopt;
+
+			return label_name(labels[*offset], *offset, base);
+		};
+
+		for (size_t offset = 0; offset < rom.size(); ++offset)
+		{
+			const auto& instruction = instructions[offset];
+
+			if (instruction && instruction->id == arch::JMP && instruction->mask == arch::MASK_ADDR)
+				if (const auto target = offset_of(arch::dec::NNN(instruction->opcode)); target && starts[*target])
+					labels[*target] = std::max(labels[*target], label_kind::location);
+		}
+
+		std::string source = std::format(";; assembles back to the same binary with --relocate 0x{:03X}\n", base);
+		auto out = std::back_inserter(source);
+
+		for (size_t offset = 0; offset < rom.size(); )
+		{
+			if (offset == 0 || labels[offset] != label_kind::none)
+				std::format_to(out, ".{}:\n", label_name(labels[offset], offset, base));
+
+			//
+			// data is written a byte at a time
+			//
+			if (offset == 0)
+				source += "    config RAW_ALIGNED = 0\n";
+
+			if (!instructions[offset])
+			{
+				std::format_to(out, "    raw(0x{:02X})\n", rom[offset]);
+				++offset;
+				continue;
+			}
+
+			const auto [opcode, mask, id] = *instructions[offset];
+			const auto instruction_id = static_cast<arch::instruction_id>(id);
+			const auto mnemonic = arch::mnemonics[instruction_id];
+
+			source += "    ";
+
+			switch (mask)
+			{
+				case arch::MASK_NONE:
+					std::format_to(out, "{}", mnemonic);
+					break;
+
+				case arch::MASK_ADDR:
+				{
+					const auto target = arch::dec::NNN(opcode);
+					const auto label = jump_label(target);
+
+					if (instruction_id == arch::JMP && label)
+						std::format_to(out, "{} @{}", mnemonic, *label);
+					else if (label)
+						std::format_to(out, "raw(0x{:04X})  ;; {} {}", opcode, mnemonic, *label);
+					else
+						std::format_to(out, "raw(0x{:04X})  ;; {} 0x{:03X}", opcode, mnemonic, target);
+
+					break;
+				}
+
+				case arch::MASK_AR_ADDR:
+					std::format_to(out, "{} ar, 0x{:03X}", mnemonic, arch::dec::NNN(opcode));
+					break;
+
+				case arch::MASK_ADDR_REL:
+					std::format_to(out, "{} [0x{:03X}]", mnemonic, arch::dec::NNN(opcode));
+					break;
+
+				default:
+					formatter::format_to(out, instruction_id, static_cast<arch::operands_mask>(mask), opcode);
+					break;
+			}
+
+			source += '\n';
+			offset += sizeof(arch::opcode);
+		}
+
+		return source;
+	}
+}
@@ -0,0 +1,186 @@
+#include <utility>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <random>
+#include <format>
+
+#include <chasm/file_io.hpp>
+#include <chasm/chasm_exception.hpp>
+
+#ifdef __unix__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+
+namespace chasm
+{
+	mapped_file::~mapped_file()
+	{
+#ifdef __unix__
+		if (address)
+			munmap(const_cast<uint8_t*>(address), size);
+#endif
+	}
+
+	mapped_file::mapped_file(mapped_file&& other) noexcept
+		: address(std::exchange(other.address, nullptr)),
+		  size(std::exchange(other.size, 0)),
+		  fallback(std::move(other.fallback))
+	{}
+
+	std::optional<mapped_file> mapped_file::open(const std::filesystem::path& path)
+	{
+		mapped_file file;
+
+#ifdef __unix__
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (fd < 0)
+			return std::nullopt;
+
+		struct stat info {};
+
+		if (fstat(fd, &info) != 0)
+		{
+			close(fd);
+			return std::nullopt;
+		}
+
+		if (info.st_size > 0)
+		{
+			void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (mapping != MAP_FAILED)
+			{
+				file.address = static_cast<const uint8_t*>(mapping);
+				file.size = static_cast<size_t>(info.st_size);
+			}
+		}
+
+		close(fd);
+
+		if (file.address || info.st_size == 0)
+			return file;
+#endif
+
+		std::ifstream is(path, std::ios::binary);
+
+		if (!is)
+			return std::nullopt;
+
+		file.fallback.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+
+		return file;
+	}
+
+	std::span<const uint8_t> mapped_file::bytes() const
+	{
+		if (address)
+			return { address, size };
+
+		return fallback;
+	}
+
+	void write_atomic(const std::filesystem::path& path, std::span<const char> data)
+	{
+		std::random_device rd;
+		const auto nonce = (static_cast<uint64_t>(rd()) << 32) | rd();
+
+		auto temp_path = path;
+		temp_path += std::format(".{:016x}.tmp", nonce);
+
+		{
+			std::ofstream os(temp_path, std::ios::binary);
+
+			if (!os)
+				throw chasm_exception("Could not open file {} for writing", temp_path.string());
+
+			os.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+			if (!os)
+			{
+				os.close();
+				std::filesystem::remove(temp_path);
+				throw chasm_exception("Could not write file {}", temp_path.string());
+			}
+		}
+
+		std::filesystem::rename(temp_path, path);
+	}
+
+	namespace
+	{
+		constexpr size_t STDIO_CHUNK_SIZE = 64 * 1024;
+
+		void set_binary_mode([[maybe_unused]] std::FILE* stream)
+		{
+#ifdef _WIN32
+			_setmode(_fileno(stream), _O_BINARY);
+#endif
+		}
+
+		template<typename Container>
+		Container read_stdin_into()
+		{
+			set_binary_mode(stdin);
+
+			Container content;
+			size_t size = 0;
+
+			for (;;)
+			{
+				content.resize(size + STDIO_CHUNK_SIZE);
+
+				const auto count = std::fread(content.data() + size, 1, STDIO_CHUNK_SIZE, stdin);
+				size += count;
+
+				if (count < STDIO_CHUNK_SIZE)
+					break;
+			}
+
+			if (std::ferror(stdin))
+				throw chasm_exception("Could not read from the standard input");
+
+			content.resize(size);
+
+			return content;
+		}
+	}
+
+	bool is_stdio(const std::filesystem::path& path)
+	{
+		return path == "-";
+	}
+
+	std::string read_stdin()
+	{
+		return read_stdin_into<std::string>();
+	}
+
+	std::vector<uint8_t> read_stdin_bytes()
+	{
+		return read_stdin_into<std::vector<uint8_t>>();
+	}
+
+	void write_stdout(std::span<const char> data)
+	{
+		set_binary_mode(stdout);
+
+		//
+		// text written through std::cout before must come out first
+		//
+		std::cout.flush();
+
+		if (std::fwrite(data.data(), 1, data.size(), stdout) != data.size() || std::fflush(stdout) != 0)
+			throw chasm_exception("Could not write to the standard output");
+	}
+}
@@ -0,0 +1,114 @@
+#include <chasm/file_watcher.hpp>
+#include <chasm/chasm_exception.hpp>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+
+namespace chasm
+{
+#ifdef __linux__
+
+	file_watcher::file_watcher(const std::filesystem::path& file)
+		: filename(file.filename())
+	{
+		auto directory = std::filesystem::absolute(file).parent_path();
+
+		inotify_fd = inotify_init1(IN_CLOEXEC);
+
+		if (inotify_fd < 0)
+			throw chasm_exception("Could not initialize inotify: {}", std::strerror(errno));
+
+		constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MODIFY;
+
+		if (inotify_add_watch(inotify_fd, directory.c_str(), mask) < 0)
+		{
+			close(inotify_fd);
+			throw chasm_exception("Could not watch directory \"{}\": {}", directory.string(), std::strerror(errno));
+		}
+	}
+
+	file_watcher::~file_watcher()
+	{
+		if (inotify_fd >= 0)
+			close(inotify_fd);
+	}
+
+	void file_watcher::wait_for_change(std::chrono::milliseconds debounce)
+	{
+		using clock = std::chrono::steady_clock;
+
+		while (!read_events(-1))
+			continue;
+
+		auto deadline = clock::now() + debounce;
+
+		for (auto now = clock::now(); now < deadline; now = clock::now())
+		{
+			const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+
+			if (read_events(static_cast<int>(remaining.count())))
+				deadline = clock::now() + debounce;
+		}
+	}
+
+	bool file_watcher::read_events(int timeout_ms)
+	{
+		pollfd pfd { .fd = inotify_fd, .events = POLLIN, .revents = 0 };
+
+		const int ready = poll(&pfd, 1, timeout_ms);
+
+		if (ready < 0 && errno != EINTR)
+			throw chasm_exception("Could not wait for file changes: {}", std::strerror(errno));
+
+		if (ready <= 0)
+			return false;
+
+		alignas(inotify_event) char buffer[4096];
+
+		const auto length = read(inotify_fd, buffer, sizeof(buffer));
+
+		if (length < 0)
+			return false;
+
+		bool relevant = false;
+
+		for (ssize_t offset = 0; offset < length; )
+		{
+			inotify_event event {};
+			std::memcpy(&event, buffer + offset, sizeof(event));
+
+			if (event.len > 0 && filename.native() == buffer + offset + sizeof(inotify_event))
+				relevant = true;
+
+			offset += static_cast<ssize_t>(sizeof(inotify_event) + event.len);
+		}
+
+		return relevant;
+	}
+
+#else
+
+	file_watcher::file_watcher(const std::filesystem::path&)
+	{
+		throw chasm_exception("Watching files for changes is only supported on Linux.");
+	}
+
+	file_watcher::~file_watcher() = default;
+
+	void file_watcher::wait_for_change(std::chrono::milliseconds)
+	{}
+
+	bool file_watcher::read_events(int)
+	{
+		return false;
+	}
+
+#endif
+}
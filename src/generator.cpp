@@ -1,8 +1,9 @@
 #include <span>
-#include <fstream>
+#include <tuple>
 #include <algorithm>
 
 #include <chasm/generator.hpp>
+#include <chasm/pass_timer.hpp>
 #include <chasm/options.hpp>
 #include <chasm/arch.hpp>
 #include <chasm/log.hpp>
@@ -10,48 +11,43 @@
 
 namespace chasm
 {
-	void generate_symbols_file(const std::filesystem::path& path,
-							   const std::unordered_map<std::string, arch::addr>& mapping)
+	void warn_super_instruction(const ast::instruction_statement& instruction)
 	{
-		std::ofstream os(path);
+		log::warn("Instruction {} at {} is a SuperCHIP-8 instruction but flag \"super\" was not provided.",
+				  instruction.mnemonic.to_string(),
+				  to_string(instruction.mnemonic.source_location));
+	}
 
-		if (!os)
+	//
+	// Instructions of a block in the order the generator visits them
+	//
+	class instruction_collector final : public ast::base_visitor
+	{
+	public:
+		void visit(const ast::procedure_statement& procedure) override
 		{
-			log::error("Could not open file \"{}\" to write symbols mapping.", path.string());
-			return;
+			collect(procedure.inner_statements);
 		}
 
-		auto sort_pred = [](const std::pair<std::string, arch::addr>& a,
-				            const std::pair<std::string, arch::addr>& b)
+		void visit(const ast::label_statement& label) override
 		{
-			return a.second < b.second;
-		};
-
-		//
-		// Sort from lowest to highest address
-		//
-		std::vector<std::pair<std::string, arch::addr>> elems(mapping.begin(), mapping.end());
-		std::sort(elems.begin(), elems.end(), sort_pred);
-
-		const auto mapped_base = options::arg<arch::addr>("relocate");
+			collect(label.inner_statements);
+		}
 
-		for (const auto& [symbol, addr] : elems)
+		void visit(const ast::instruction_statement& instruction) override
 		{
-			const arch::addr addr_file = addr;
-			const arch::addr addr_mem  = addr + mapped_base;
-
-			os << std::format("{:#06x} {:#06x} --> {}", addr_file, addr_mem, symbol) << std::endl;
+			instructions.push_back(&instruction);
 		}
 
-		log::info("{} symbols mapping written to \"{}\".", mapping.size(), path.string());
-	}
+		std::vector<const ast::instruction_statement*> instructions;
 
-	void warn_super_instruction(const ast::instruction_statement& instruction)
-	{
-		log::warn("Instruction {} at {} is a SuperCHIP-8 instruction but flag \"super\" was not provided.",
-				  instruction.mnemonic.to_string(),
-				  to_string(instruction.mnemonic.source_location));
-	}
+	private:
+		void collect(const std::vector<ast::statement>& statements)
+		{
+			for (const auto& inner : statements)
+				inner->accept(*this);
+		}
+	};
 
 	[[nodiscard]]
 	arch::reg operand2reg(const ast::instruction_operand& operand)
@@ -97,55 +93,117 @@ namespace chasm
 			throw generator_exception::invalid_operands_count(inst, { expected_count });
 	}
 
+	generator::generator(incremental_state& state)
+		: incremental(&state)
+	{}
+
 	std::vector<uint8_t> generator::generate(const ast::abstract_tree& ast)
 	{
+		if (incremental)
+			incremental->begin();
+
 		for (const auto& branch : ast.branches())
 			branch->accept(*this);
 
 		post_visit();
 
+		if (incremental)
+			incremental->commit();
+
 		return binary;
 	}
 
-	void generator::post_visit()
+	std::vector<uint8_t> generator::finalize()
 	{
+		post_visit();
+
+		return std::move(binary);
+	}
+
+	object_file generator::generate_object(const ast::abstract_tree& ast)
+	{
+		for (const auto& branch : ast.branches())
+			branch->accept(*this);
+
+		layout_sprites();
+
+		object_file object { .code = std::move(binary) };
+
 		//
-		// Add sprites to the end of the code
+		// sprites cannot be referenced from another object, they stay local so that
+		// objects declaring sprites of the same name link together
 		//
-		for (const auto& [name, sprite] : sprites)
+		for (const auto& [sym, addr] : sym_addresses)
+			(object_file::is_local(sym) || sprites.contains(sym) ? object.locals : object.exports).push_back({ sym, addr });
+
+		for (auto& [location, sym] : patches)
 		{
-			register_symbol_addr(name);
+			if (!sym_addresses.contains(sym) && !std::ranges::contains(object.imports, sym))
+				object.imports.push_back(sym);
 
-			binary.append_range(std::span(sprite.data.begin(), sprite.row_count));
+			object.relocations.push_back({ static_cast<arch::size_type>(location), std::move(sym) });
+		}
 
-			const bool misaligned = binary.size() % sizeof(arch::opcode) != 0;
+		//
+		// keep the object file content stable from one build to the next
+		//
+		auto by_offset = [](const object_file::symbol& a, const object_file::symbol& b)
+		{
+			return std::tie(a.offset, a.name) < std::tie(b.offset, b.name);
+		};
 
-			if (misaligned && options::has_flag("pad-sprites"))
-				binary.push_back(0x00);
-		}
+		std::ranges::sort(object.exports, by_offset);
+		std::ranges::sort(object.locals, by_offset);
+
+		return object;
+	}
+
+	const std::vector<source_line>& generator::source_lines() const
+	{
+		return lines;
+	}
+
+	void generator::post_visit()
+	{
+		layout_sprites();
 
 		const auto base_addr = options::arg<arch::addr>("relocate");
 
+		{
+			passes::scoped_pass pass("patch");
+
+			//
+			// Apply jmp/call patches that could not be encoded directly
+			//
+			for (const auto& [location, sym] : patches)
+				apply_relocation(binary, location, sym, base_addr + sym_addresses[sym]);
+		}
+
+		if (options::has_flag("symbols"))
+		{
+			passes::scoped_pass pass("symbols");
+			generate_symbols_file(options::arg<std::string>("symbols"), sym_addresses, lines);
+		}
+	}
+
+	void generator::layout_sprites()
+	{
 		//
-		// Apply jmp/call patches that could not be encoded directly
+		// Add sprites to the end of the code
 		//
-		for (const auto& [location, sym] : patches)
+		for (const auto& name : sprite_order)
 		{
-			const uintptr_t relocated = base_addr + sym_addresses[sym];
+			const auto& sprite = sprites.at(name);
 
-			if (relocated > std::numeric_limits<arch::addr>::max())
-				throw chasm_exception("Symbol \"{}\" relocated to address {:x} which is out of the chip8's memory range.\n"
-									  "Assembler cannot generate address patch at {:x}",
-									  sym,
-									  relocated,
-									  location * sizeof(arch::opcode));
+			register_symbol_addr(name);
 
-			binary[location + 0] |= ((static_cast<arch::addr>(relocated) & 0x0F00) >> 8);
-			binary[location + 1] |= ((static_cast<arch::addr>(relocated) & 0x00FF));
-		}
+			binary.append_range(std::span(sprite.data.begin(), sprite.row_count));
 
-		if (options::has_flag("symbols"))
-			generate_symbols_file(options::arg<std::string>("symbols"), sym_addresses);
+			const bool misaligned = binary.size() % sizeof(arch::opcode) != 0;
+
+			if (misaligned && options::has_flag("pad-sprites"))
+				binary.push_back(0x00);
+		}
 	}
 
 	void generator::emit_byte(uint8_t b)
@@ -165,20 +223,122 @@ namespace chasm
 			emit_opcode(opcode);
 	}
 
+	template<std::invocable Encoder>
+	void generator::encode_block(const ast::base_statement& block, size_t line, Encoder&& encode)
+	{
+		if (!incremental || recording)
+		{
+			encode();
+			return;
+		}
+
+		const auto key = incremental_state::fingerprint(block, environment);
+
+		if (const auto cached = incremental->reuse(key))
+		{
+			replay_block(block, *cached, line);
+			return;
+		}
+
+		incremental_state::block encoded;
+
+		recording = &encoded;
+		recording_start = binary.size();
+		recording_line = line;
+		recording_instructions = 0;
+
+		encode();
+
+		recording = nullptr;
+
+		encoded.code.assign(binary.begin() + static_cast<std::ptrdiff_t>(recording_start), binary.end());
+
+		for (const auto& [id, value] : cfg.values())
+			encoded.configs.emplace_back(id, value);
+
+		encoded.exit_environment = environment;
+
+		incremental->insert(key, std::move(encoded));
+	}
+
+	void generator::replay_block(const ast::base_statement& block, const incremental_state::block& cached, size_t line)
+	{
+		const auto base = binary.size();
+
+		binary.insert(binary.end(), cached.code.begin(), cached.code.end());
+
+		for (const auto& [sym, offset] : cached.symbols)
+			register_symbol_addr(sym, static_cast<arch::addr>(base + offset));
+
+		for (const auto& [sym, offset] : cached.patches)
+			patches.push_back({ .location = base + offset, .sym = sym });
+
+		for (const auto& [offset, line_delta] : cached.lines)
+			lines.push_back({ static_cast<arch::addr>(base + offset), static_cast<uint32_t>(line + line_delta) });
+
+		for (const auto& [sym, value] : cached.constants)
+			constants[sym] = value;
+
+		for (const auto& [id, value] : cached.configs)
+			cfg.set(id, value);
+
+		environment = cached.exit_environment;
+
+		if (cached.super_instructions.empty() || options::has_flag("super"))
+			return;
+
+		instruction_collector collector;
+		block.accept(collector);
+
+		for (const auto index : cached.super_instructions)
+			if (index < collector.instructions.size())
+				warn_super_instruction(*collector.instructions[index]);
+	}
+
+	void generator::super_instruction(const ast::instruction_statement& instruction)
+	{
+		if (recording)
+			recording->super_instructions.push_back(recording_instructions - 1);
+
+		if (!options::has_flag("super"))
+			warn_super_instruction(instruction);
+	}
+
+	template<typename... Args>
+	void generator::update_environment(Args&&... args)
+	{
+		if (!incremental)
+			return;
+
+		hasher h;
+		h.update(environment);
+		(h.update(args), ...);
+
+		environment = h.digest();
+	}
+
 	void generator::visit(const ast::procedure_statement& procedure)
 	{
-		register_symbol_addr(procedure.name_beg.to_string());
+		encode_block(procedure, procedure.name_beg.source_location.line, [&]
+		{
+			register_symbol_addr(procedure.name_beg.to_string());
 
-		current_proc_name = procedure.name_beg.to_string();
+			current_proc_name = procedure.name_beg.to_string();
 
-		for (const auto& inner : procedure.inner_statements)
-			inner->accept(*this);
+			for (const auto& inner : procedure.inner_statements)
+				inner->accept(*this);
 
-		current_proc_name = "";
+			current_proc_name = "";
+		});
 	}
 
 	void generator::visit(const ast::instruction_statement& instruction)
 	{
+		record_line(instruction.mnemonic.source_location.line);
+
+		if (recording)
+			++recording_instructions;
+
 		const auto inst_id = instruction.to_arch_id();
 
 		if (mnemonic_encoders.contains(inst_id))
@@ -193,8 +353,7 @@ namespace chasm
 		}
 		else if (super_mnemonic_encoders.contains(inst_id))
 		{
-			if (!options::has_flag("super"))
-				warn_super_instruction(instruction);
+			super_instruction(instruction);
 
 			auto encoder = super_mnemonic_encoders.at(inst_id);
 			emit_opcode((this->*encoder)(instruction));
@@ -214,6 +373,8 @@ namespace chasm
 			cfg.reset(id);
 		else
 			cfg.set(id, statement.value.to_integer());
+
+		update_environment(std::string_view("config"), std::string_view(id), statement.value.to_string());
 	}
 
 	void generator::visit(const ast::sprite_statement& sprite_statement)
@@ -223,10 +384,13 @@ namespace chasm
 
 	void generator::visit(const ast::label_statement& label)
 	{
-		register_symbol_addr(current_proc_name + "." + label.identifier.to_string());
+		encode_block(label, label.identifier.source_location.line, [&]
+		{
+			register_symbol_addr(current_proc_name + "." + label.identifier.to_string());
 
-		for (const auto& inner : label.inner_statements)
-			inner->accept(*this);
+			for (const auto& inner : label.inner_statements)
+				inner->accept(*this);
+		});
 	}
 
 	void generator::visit(const ast::raw_statement& statement)
@@ -235,6 +399,8 @@ namespace chasm
 
 		const arch::imm v = operand2imm(statement.opcode, arch::fmt_imm16);
 
+		record_line(statement.source_line());
+
 		if (aligned || v > std::numeric_limits<uint8_t>::max())
 			emit_opcode(v);
 		else
@@ -243,6 +409,11 @@ namespace chasm
 
 	void generator::register_constant(std::string &&symbol, arch::imm value)
 	{
+		update_environment(std::string_view("define"), std::string_view(symbol), value);
+
+		if (recording)
+			recording->constants.emplace_back(symbol, value);
+
 		//
 		// The sanitizer has already made sure it is not the same scope,
 		// so we can safely overwrite the previous definition
@@ -255,25 +426,52 @@ namespace chasm
 		if (sprites.contains(symbol))
 			throw chasm_exception("Generator found an already defined sprite \"{}\", this should have been caught by the sanitizer.", symbol);
 
+		update_environment(std::string_view("sprite"),
+						   std::string_view(symbol),
+						   std::span(sprite.data.begin(), sprite.row_count));
+
+		sprite_order.push_back(symbol);
 		sprites[std::move(symbol)] = sprite;
 	}
 
 	void generator::register_symbol_addr(std::string symbol)
+	{
+		if (recording)
+			recording->symbols.push_back({ symbol, static_cast<arch::size_type>(binary.size() - recording_start) });
+
+		register_symbol_addr(std::move(symbol), static_cast<arch::addr>(binary.size()));
+	}
+
+	void generator::register_symbol_addr(std::string symbol, arch::addr address)
 	{
 		if (sym_addresses.contains(symbol))
 			throw chasm_exception("Generator found an already existing symbol \"{}\", this should have been caught by the sanitizer.", symbol);
 
-		sym_addresses[std::move(symbol)] = binary.size();
+		sym_addresses[std::move(symbol)] = address;
 	}
 
 	void generator::register_patch_location(std::string&& symbol)
 	{
+		if (recording)
+			recording->patches.push_back({ symbol, static_cast<arch::size_type>(binary.size() - recording_start) });
+
 		patches.push_back({
 			.location = static_cast<arch::addr>(binary.size()),
 			.sym = std::move(symbol)
 		});
 	}
 
+	void generator::record_line(size_t line)
+	{
+		if (recording)
+			recording->lines.push_back({
+				static_cast<arch::size_type>(binary.size() - recording_start),
+				static_cast<uint32_t>(line - recording_line)
+			});
+
+		lines.push_back({ static_cast<arch::addr>(binary.size()), static_cast<uint32_t>(line) });
+	}
+
 	arch::imm generator::operand2imm(const token& token, arch::imm_format imm_width) const
 	{
 		arch::imm imm = 0;
@@ -479,8 +677,8 @@ namespace chasm
 				const auto regY = operand2reg(draw.operands[1]);
 				const auto imm4 = operand2imm(draw.operands[2], arch::fmt_imm4);
 
-				if (imm4 == 0 && !options::has_flag("super"))
-					warn_super_instruction(draw);
+				if (imm4 == 0)
+					super_instruction(draw);
 
 				return arch::enc::_DXYN(regX, regY, imm4);
 			}
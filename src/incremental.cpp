@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <fstream>
+
+#include <chasm/incremental.hpp>
+#include <chasm/binary_io.hpp>
+#include <chasm/version.hpp>
+#include <chasm/log.hpp>
+
+
+namespace chasm
+{
+	namespace
+	{
+		constexpr std::string_view STATE_MAGIC = "C8I";
+		constexpr uint8_t STATE_FORMAT = 3;
+
+		class fingerprinter final : public ast::base_visitor
+		{
+		public:
+			explicit fingerprinter(hasher& h_)
+				: h(h_)
+			{}
+
+			void visit(const ast::procedure_statement& statement) override
+			{
+				h.update("proc");
+				hash(statement.name_beg);
+				hash(statement.inner_statements);
+			}
+
+			void visit(const ast::instruction_statement& statement) override
+			{
+				h.update("inst");
+				hash(statement.mnemonic);
+				h.update(statement.operands.size());
+
+				for (const auto& operand : statement.operands)
+				{
+					h.update(operand.is_reg())
+					 .update(operand.has_indirection())
+					 .update(operand.is_label())
+					 .update(operand.is_procedure())
+					 .update(operand.is_sprite());
+
+					hash(operand.operand);
+				}
+			}
+
+			void visit(const ast::define_statement& statement) override
+			{
+				h.update("define");
+				hash(statement.identifier);
+				hash(statement.value);
+			}
+
+			void visit(const ast::config_statement& statement) override
+			{
+				h.update("config");
+				hash(statement.identifier);
+				hash(statement.value);
+			}
+
+			void visit(const ast::sprite_statement& statement) override
+			{
+				h.update("sprite");
+				hash(statement.identifier);
+				h.update(std::span(statement.sprite.data.begin(), statement.sprite.row_count));
+			}
+
+			void visit(const ast::raw_statement& statement) override
+			{
+				h.update("raw");
+				hash(statement.opcode);
+			}
+
+			void visit(const ast::label_statement& statement) override
+			{
+				h.update("label");
+				hash(statement.identifier);
+				hash(statement.inner_statements);
+			}
+
+		private:
+			void hash(const token& t)
+			{
+				//
+				// source locations are left out on purpose, moving a block around
+				// in the source must not invalidate it
+				//
+				h.update(static_cast<int>(t.type));
+
+				if (std::holds_alternative<uint16_t>(t.data))
+					h.update(std::get<uint16_t>(t.data));
+				else
+					h.update(t.text());
+			}
+
+			void hash(const std::vector<ast::statement>& statements)
+			{
+				h.update(statements.size());
+
+				for (const auto& inner : statements)
+					inner->accept(*this);
+			}
+
+		private:
+			hasher& h;
+		};
+
+		void write_symbols(binary_writer& writer, const std::vector<incremental_state::relative_symbol>& symbols)
+		{
+			writer.write(static_cast<uint32_t>(symbols.size()));
+
+			for (const auto& [name, offset] : symbols)
+				writer.write(std::string_view(name)).write(offset);
+		}
+
+		std::vector<incremental_state::relative_symbol> read_symbols(binary_reader& reader)
+		{
+			std::vector<incremental_state::relative_symbol> symbols(reader.read<uint32_t>());
+
+			for (auto& [name, offset] : symbols)
+			{
+				name = reader.read_string();
+				offset = reader.read<arch::size_type>();
+			}
+
+			return symbols;
+		}
+	}
+
+	incremental_state::key_type incremental_state::fingerprint(const ast::base_statement& statement, key_type environment)
+	{
+		hasher h;
+		h.update(environment);
+
+		fingerprinter visitor(h);
+		statement.accept(visitor);
+
+		return h.digest();
+	}
+
+	void incremental_state::begin()
+	{
+		current.clear();
+
+		reused = 0;
+		encoded = 0;
+	}
+
+	void incremental_state::commit()
+	{
+		previous = std::move(current);
+		current.clear();
+	}
+
+	std::shared_ptr<const incremental_state::block> incremental_state::reuse(key_type key)
+	{
+		auto it = previous.find(key);
+
+		if (it == previous.end())
+			return nullptr;
+
+		++reused;
+		current[key] = it->second;
+
+		return it->second;
+	}
+
+	void incremental_state::insert(key_type key, block&& encoded_block)
+	{
+		++encoded;
+		current[key] = std::make_shared<const block>(std::move(encoded_block));
+	}
+
+	size_t incremental_state::reused_count() const
+	{
+		return reused;
+	}
+
+	size_t incremental_state::encoded_count() const
+	{
+		return encoded;
+	}
+
+	incremental_state incremental_state::load(const std::filesystem::path& path)
+	{
+		incremental_state state;
+
+		std::ifstream is(path, std::ios::binary);
+
+		if (!is)
+			return state;
+
+		const std::vector<uint8_t> content { std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+
+		try
+		{
+			binary_reader reader(content);
+
+			const auto magic = reader.read_raw(STATE_MAGIC.size());
+
+			if (!std::ranges::equal(magic, STATE_MAGIC) ||
+				reader.read<uint8_t>() != STATE_FORMAT ||
+				reader.read_string() != version)
+			{
+				log::warn("Incremental state \"{}\" was written by another chasm version, ignored", path.string());
+				return state;
+			}
+
+			for (auto count = reader.read<uint32_t>(); count > 0; --count)
+			{
+				const auto key = reader.read<key_type>();
+
+				block b;
+
+				const auto code = reader.read_bytes();
+				b.code.assign(code.begin(), code.end());
+				b.symbols = read_symbols(reader);
+				b.patches = read_symbols(reader);
+
+				b.lines.resize(reader.read<uint32_t>());
+
+				for (auto& [offset, line_delta] : b.lines)
+				{
+					offset = reader.read<arch::size_type>();
+					line_delta = reader.read<uint32_t>();
+				}
+
+				b.constants.resize(reader.read<uint32_t>());
+
+				for (auto& [name, value] : b.constants)
+				{
+					name = reader.read_string();
+					value = reader.read<arch::imm>();
+				}
+
+				b.configs.resize(reader.read<uint32_t>());
+
+				for (auto& [name, value] : b.configs)
+				{
+					name = reader.read_string();
+					value = reader.read<int32_t>();
+				}
+
+				b.exit_environment = reader.read<key_type>();
+
+				b.super_instructions.resize(reader.read<uint32_t>());
+
+				for (auto& index : b.super_instructions)
+					index = reader.read<uint32_t>();
+
+				state.previous[key] = std::make_shared<const block>(std::move(b));
+			}
+		}
+		catch (const chasm_exception& error)
+		{
+			log::warn("Incremental state \"{}\" is corrupted and was ignored: {}", path.string(), error.what());
+			state.previous.clear();
+		}
+
+		return state;
+	}
+
+	void incremental_state::save(const std::filesystem::path& path) const
+	{
+		binary_writer writer;
+
+		writer.write_raw(std::span(reinterpret_cast<const uint8_t*>(STATE_MAGIC.data()), STATE_MAGIC.size()))
+			  .write(STATE_FORMAT)
+			  .write(version)
+			  .write(static_cast<uint32_t>(previous.size()));
+
+		//
+		// written by key rather than in hash order, for the same state to give the same file
+		//
+		std::vector<block_map::const_pointer> entries;
+		entries.reserve(previous.size());
+
+		for (const auto& entry : previous)
+			entries.push_back(&entry);
+
+		std::ranges::sort(entries, {}, [](block_map::const_pointer entry) { return entry->first; });
+
+		for (const auto* entry : entries)
+		{
+			const auto& [key, b] = *entry;
+
+			writer.write(key).write(b->code);
+
+			write_symbols(writer, b->symbols);
+			write_symbols(writer, b->patches);
+
+			writer.write(static_cast<uint32_t>(b->lines.size()));
+
+			for (const auto& [offset, line_delta] : b->lines)
+				writer.write(offset).write(line_delta);
+
+			writer.write(static_cast<uint32_t>(b->constants.size()));
+
+			for (const auto& [name, value] : b->constants)
+				writer.write(std::string_view(name)).write(value);
+
+			writer.write(static_cast<uint32_t>(b->configs.size()));
+
+			for (const auto& [name, value] : b->configs)
+				writer.write(std::string_view(name)).write(static_cast<int32_t>(value));
+
+			writer.write(b->exit_environment);
+
+			writer.write(static_cast<uint32_t>(b->super_instructions.size()));
+
+			for (const auto index : b->super_instructions)
+				writer.write(index);
+		}
+
+		std::ofstream os(path, std::ios::binary);
+
+		if (!os)
+		{
+			log::error("Could not open file \"{}\" to write incremental state.", path.string());
+			return;
+		}
+
+		os.write(reinterpret_cast<const char*>(writer.data().data()), static_cast<std::streamsize>(writer.size()));
+	}
+}
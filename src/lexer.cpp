@@ -101,8 +101,11 @@ namespace chasm
 	{
 		std::vector<token> tokens;
 
-		for (auto token = next_token(); token.type != token_type::eof; token = next_token())
-			tokens.push_back(token);
+		enumerate_tokens([&tokens](token&& t)
+		{
+			tokens.push_back(std::move(t));
+			return true;
+		});
 
 		return tokens;
 	}
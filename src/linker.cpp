@@ -0,0 +1,107 @@
+#include <algorithm>
+
+#include <chasm/linker.hpp>
+#include <chasm/chasm_exception.hpp>
+
+
+namespace chasm
+{
+	void linker::add(object_file&& object, std::string name)
+	{
+		inputs.push_back({ .object = std::move(object), .name = std::move(name) });
+	}
+
+	std::vector<uint8_t> linker::link(arch::addr base_address)
+	{
+		const auto entry = std::ranges::find_if(inputs, &object_file::defines_entry_point, &input::object);
+
+		if (entry == inputs.end())
+			throw chasm_exception("No object file defines the entry-point label \".main\".");
+
+		if (const auto other = std::find_if(std::next(entry), inputs.end(), [](const input& in) { return in.object.defines_entry_point(); });
+			other != inputs.end())
+			throw chasm_exception("Entry-point label \".main\" is defined in both {} and {}.", entry->name, other->name);
+
+		std::rotate(inputs.begin(), entry, std::next(entry));
+
+		//
+		// Lay out the objects and collect the exported symbols
+		//
+		std::vector<uint8_t> binary;
+
+		struct exported
+		{
+			const input* owner;
+			arch::addr address;
+		};
+
+		std::unordered_map<std::string, exported> exports;
+
+		linked_symbols.clear();
+
+		for (auto& in : inputs)
+		{
+			if (!arch::is_aligned(static_cast<arch::addr>(binary.size())))
+				binary.push_back(0x00);
+
+			in.base = static_cast<arch::addr>(binary.size());
+			binary.insert(binary.end(), in.object.code.begin(), in.object.code.end());
+
+			for (const auto& [name, offset] : in.object.exports)
+			{
+				const auto address = static_cast<arch::addr>(in.base + offset);
+
+				if (const auto [it, inserted] = exports.try_emplace(name, &in, address); !inserted)
+					throw chasm_exception("Symbol \"{}\" is defined in both {} and {}.", name, it->second.owner->name, in.name);
+
+				linked_symbols[name] = address;
+			}
+		}
+
+		//
+		// Resolve the relocations, local labels first
+		//
+		for (const auto& in : inputs)
+		{
+			std::unordered_map<std::string_view, arch::addr> locals;
+
+			for (const auto& [name, offset] : in.object.locals)
+			{
+				const auto address = static_cast<arch::addr>(in.base + offset);
+
+				locals[name] = address;
+
+				//
+				// top-level labels (".label") and sprites ("sprite") may collide between objects
+				//
+				if (&in != &inputs.front() && name.starts_with('.'))
+					linked_symbols[in.name + name] = address;
+				else if (&in != &inputs.front() && !object_file::is_local(name))
+					linked_symbols[in.name + '.' + name] = address;
+				else
+					linked_symbols[name] = address;
+			}
+
+			for (const auto& [location, symbol] : in.object.relocations)
+			{
+				arch::addr target;
+
+				if (const auto local = locals.find(symbol); local != locals.end())
+					target = local->second;
+				else if (const auto global = exports.find(symbol); global != exports.end())
+					target = global->second.address;
+				else
+					throw chasm_exception("Undefined symbol \"{}\" referenced by {}.", symbol, in.name);
+
+				apply_relocation(binary, in.base + location, symbol, base_address + target);
+			}
+		}
+
+		return binary;
+	}
+
+	const std::unordered_map<std::string, arch::addr>& linker::symbols() const
+	{
+		return linked_symbols;
+	}
+}
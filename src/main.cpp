@@ -1,7 +1,27 @@
+#include <algorithm>
+#include <sstream>
+#include <optional>
 #include <vector>
+#include <chrono>
+#include <cctype>
 
 #include <chasm/ds/disassembly_interface.hpp>
+#include <chasm/ds/control_flow_graph.hpp>
+#include <chasm/ds/listing_renderer.hpp>
 #include <chasm/ds/disassembler.hpp>
+#include <chasm/ds/batch.hpp>
+#include <chasm/build_cache.hpp>
+#include <chasm/ast_cache.hpp>
+#include <chasm/file_watcher.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/output_format.hpp>
+#include <chasm/incremental.hpp>
+#include <chasm/pass_timer.hpp>
+#include <chasm/trace.hpp>
+#include <chasm/generator.hpp>
+#include <chasm/pipeline.hpp>
+#include <chasm/project.hpp>
+#include <chasm/linker.hpp>
 #include <chasm/options.hpp>
 #include <chasm/parser.hpp>
 #include <chasm/lexer.hpp>
@@ -12,6 +32,11 @@ namespace io
 {
 	std::string content(const std::filesystem::path& path)
 	{
+		chasm::passes::scoped_pass pass("read");
+
+		if (chasm::is_stdio(path))
+			return chasm::read_stdin();
+
 		if (path.extension() != ".c8")
 			chasm::log::warn("Input file does not have the c8 extension");
 
@@ -23,46 +48,439 @@ namespace io
 		return { std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
 	}
 
+	std::optional<std::string> text(const std::filesystem::path& path)
+	{
+		if (chasm::is_stdio(path))
+			return std::nullopt;
+
+		std::ifstream is(path, std::ios::binary);
+
+		if (!is)
+			return std::nullopt;
+
+		return std::string { std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+	}
+
 	std::vector<uint8_t> bytes(const std::filesystem::path& path)
 	{
-		std::basic_ifstream<uint8_t> is(path, std::ios::binary);
+		chasm::passes::scoped_pass pass("read");
+
+		if (chasm::is_stdio(path))
+			return chasm::read_stdin_bytes();
+
+		//
+		// std::basic_ifstream<uint8_t> has no codecvt facet with libstdc++ and throws std::bad_cast
+		//
+		std::ifstream is(path, std::ios::binary);
 
 		if (!is)
 			throw std::runtime_error("Could not open assembled source file " + path.string() + " for reading");
 
-		return { std::istreambuf_iterator<uint8_t>(is), std::istreambuf_iterator<uint8_t>() };
+		return { std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
 	}
 
 	void write(const std::filesystem::path& file, const std::vector<uint8_t>& binary)
 	{
-		std::ofstream os(file, std::ios::binary);
-
-		if (!os)
-			throw std::runtime_error("Could not open file " + file.string() + " for writing");
-
 		if (binary.size() > chasm::arch::MAX_PROGRAM_SIZE)
 			chasm::log::warn("CHIP-8 programs are generally up to {} bytes but input file assembled to {} bytes.",
 							 chasm::arch::MAX_PROGRAM_SIZE,
 							 binary.size());
 
+		if (chasm::is_stdio(file))
+			return chasm::write_stdout({ reinterpret_cast<const char*>(binary.data()), binary.size() });
+
+		std::ofstream os(file, std::ios::binary);
+
+		if (!os)
+			throw std::runtime_error("Could not open file " + file.string() + " for writing");
+
 		os.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
 	}
 
+	void write(const std::filesystem::path& file, const std::string& text)
+	{
+		if (chasm::is_stdio(file))
+			return chasm::write_stdout(text);
+
+		std::ofstream os(file, std::ios::binary);
+
+		if (!os)
+			throw std::runtime_error("Could not open file " + file.string() + " for writing");
+
+		os.write(text.data(), static_cast<std::streamsize>(text.size()));
+	}
+
 	void hexdump(const std::vector<uint8_t>& binary)
 	{
-		const auto offset  = chasm::options::arg<chasm::arch::addr>("relocate");
-		const auto perline = chasm::options::arg<unsigned int>("hex");
-		const auto binsize = static_cast<chasm::arch::size_type>(binary.size());
+		const auto params = chasm::output::encode_parameters {
+			.base = chasm::options::arg<chasm::arch::addr>("relocate"),
+			.bytes_per_line = chasm::options::arg<unsigned int>("hex")
+		};
+
+		chasm::log::stream() << chasm::output::encode(chasm::output::format::hexdump, binary, params);
+	}
+}
+
+namespace build
+{
+	//
+	// A valid C identifier naming the array of the C header after the output file
+	//
+	std::string array_name(const std::filesystem::path& ofile)
+	{
+		auto name = chasm::is_stdio(ofile) ? std::string("chasm_program") : ofile.stem().string();
+
+		for (auto& c : name)
+			if (!std::isalnum(static_cast<unsigned char>(c)))
+				c = '_';
+
+		if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front())))
+			name.insert(name.begin(), '_');
+
+		return name;
+	}
+
+	void output(const std::string& ofile, const std::vector<uint8_t>& binary)
+	{
+		chasm::passes::scoped_pass pass("write");
 
-		for (chasm::arch::addr curr = 0; curr < binsize; curr += perline)
+		if (chasm::options::has_flag("hex"))
+			io::hexdump(binary);
+
+		//
+		// object files are only meant for the linker
+		//
+		if (chasm::options::has_flag("object"))
+			return io::write(ofile, binary);
+
+		const auto& formats = chasm::options::arg<std::vector<std::string>>("format");
+		const auto name = array_name(ofile);
+
+		const auto params = chasm::output::encode_parameters {
+			.base = chasm::options::arg<chasm::arch::addr>("relocate"),
+			.bytes_per_line = chasm::options::has_flag("hex") ? chasm::options::arg<unsigned int>("hex") : 4,
+			.array_name = name
+		};
+
+		for (const auto& [format, path] : chasm::output::output_files(ofile, formats))
+		{
+			if (format == chasm::output::format::raw)
+				io::write(path, binary);
+			else
+				io::write(path, chasm::output::encode(format, binary, params));
+		}
+	}
+
+	std::optional<chasm::ast::abstract_tree> parse(std::string&& source, const std::string& ifile)
+	{
+		const bool use_ast_cache = chasm::options::has_flag("ast-cache") && !chasm::is_stdio(ifile);
+
+		std::filesystem::path ast_path;
+		chasm::ast_cache::key_type source_key {};
+
+		if (use_ast_cache)
 		{
-			std::cout << std::format("0x{:04X}: ", offset + curr);
+			ast_path = chasm::ast_cache::path_for(ifile);
+			source_key = chasm::ast_cache::make_key(source);
 
-			for (int j = 0; j < perline; ++j)
-				if (curr + j < binsize)
-					std::cout << std::format("{:02X} ", binary[curr + j]);
+			if (auto tree = chasm::ast_cache::load(ast_path, source_key))
+			{
+				chasm::trace::instant("ast cache hit", "cache", ifile);
+				return tree;
+			}
 
-			std::cout << '\n';
+			chasm::trace::instant("ast cache miss", "cache", ifile);
+		}
+
+		auto tokens = [&]
+		{
+			chasm::passes::scoped_pass pass("lex");
+
+			auto lexer = chasm::lexer(std::move(source));
+			return lexer.enumerate_tokens();
+		}();
+
+		if (tokens.empty())
+		{
+			chasm::log::warn("No input to be read.\n");
+			return std::nullopt;
+		}
+
+		auto tree = [&]
+		{
+			chasm::passes::scoped_pass pass("parse");
+
+			auto parser = chasm::parser(std::move(tokens));
+			return parser.make_tree();
+		}();
+
+		//
+		// stored before generation, which reorders the statements
+		//
+		if (use_ast_cache)
+			chasm::ast_cache::store(ast_path, source_key, tree);
+
+		return tree;
+	}
+
+	std::optional<std::vector<uint8_t>> generate(std::string&& source, const std::string& ifile, chasm::incremental_state* incremental)
+	{
+		const bool object = chasm::options::has_flag("object");
+
+		//
+		// the other modes need the whole tree at once
+		//
+		if (chasm::options::has_flag("pipeline") && !object && !incremental && !chasm::options::has_flag("ast-cache"))
+		{
+			chasm::passes::scoped_pass pass("pipeline");
+			return chasm::assemble_pipelined(std::move(source));
+		}
+
+		auto tree = parse(std::move(source), ifile);
+
+		if (!tree)
+			return std::nullopt;
+
+		if (object)
+			return tree->generate_object().serialize();
+
+		if (!incremental)
+			return tree->generate();
+
+		auto binary = tree->generate(*incremental);
+
+		if (chasm::options::has_flag("incremental"))
+		{
+			incremental->save(chasm::options::arg<std::string>("incremental"));
+
+			chasm::log::info("{} blocks reused, {} blocks encoded",
+							 incremental->reused_count(),
+							 incremental->encoded_count());
+		}
+
+		return binary;
+	}
+
+	void assemble(std::string&& source, const std::string& ifile, const std::string& ofile, chasm::incremental_state* incremental)
+	{
+		chasm::trace::scoped_span span("assemble", "file", ifile);
+
+		const bool object = chasm::options::has_flag("object");
+		const bool with_symbols = chasm::options::has_flag("symbols") && !object;
+
+		std::optional<chasm::build_cache> cache;
+		chasm::build_cache::key_type cache_key {};
+
+		if (chasm::options::has_flag("cache"))
+		{
+			cache.emplace(chasm::options::arg<std::string>("cache"), chasm::options::arg<uintmax_t>("cache-size"));
+			cache_key = chasm::build_cache::make_key(source);
+
+			const auto hit = cache->lookup(cache_key, with_symbols);
+
+			chasm::trace::instant(hit ? "build cache hit" : "build cache miss", "cache", ifile);
+
+			if (hit)
+			{
+				if (hit->symbols)
+					io::write(chasm::options::arg<std::string>("symbols"), *hit->symbols);
+
+				output(ofile, hit->binary);
+
+				chasm::log::info("Build of file {} to {} retrieved from cache", ifile, ofile);
+				return;
+			}
+		}
+
+		const auto binary = generate(std::move(source), ifile, incremental);
+
+		if (!binary)
+			return;
+
+		output(ofile, *binary);
+
+		if (cache)
+			cache->store(cache_key,
+						 *binary,
+						 with_symbols ? io::text(chasm::options::arg<std::string>("symbols")) : std::nullopt);
+
+		chasm::log::info("Build of file {} to {} finished", ifile, ofile);
+	}
+
+	void link(const std::vector<std::string>& objects, const std::string& ofile)
+	{
+		auto linker = chasm::linker();
+
+		for (const auto& path : objects)
+		{
+			try
+			{
+				linker.add(chasm::object_file::deserialize(io::bytes(path)), std::filesystem::path(path).stem().string());
+			}
+			catch (const chasm::chasm_exception& error)
+			{
+				throw chasm::chasm_exception("Could not read object file {}: {}", path, error.what());
+			}
+		}
+
+		const auto binary = [&]
+		{
+			chasm::passes::scoped_pass pass("link");
+			return linker.link(chasm::options::arg<chasm::arch::addr>("relocate"));
+		}();
+
+		if (chasm::options::has_flag("symbols"))
+			chasm::generate_symbols_file(chasm::options::arg<std::string>("symbols"), linker.symbols());
+
+		output(ofile, binary);
+
+		chasm::log::info("Linked {} object files to {}", objects.size(), ofile);
+	}
+
+	void project(const std::filesystem::path& manifest)
+	{
+		using clock = std::chrono::steady_clock;
+
+		const auto start = clock::now();
+		const auto project = chasm::project::load(manifest);
+		const auto ofile = project.output().value_or(chasm::options::arg<std::string>("out"));
+
+		const auto binary = [&]
+		{
+			chasm::passes::scoped_pass pass("project");
+			return project.build(manifest.parent_path() / ".chasm-build", chasm::options::arg<unsigned int>("jobs"));
+		}();
+
+		output(ofile.string(), binary);
+
+		const auto elapsed = std::chrono::duration<double, std::milli>(clock::now() - start);
+
+		chasm::log::info("Build of project {} to {} finished in {:.3f} ms", manifest.string(), ofile.string(), elapsed.count());
+	}
+
+	chasm::ds::disassembly_mode disassembly_mode()
+	{
+		const auto mode = chasm::ds::parse_disassembly_mode(chasm::options::arg<std::string>("dis-mode"));
+
+		if (!mode)
+			throw chasm::chasm_exception("Unknown disassembly mode \"{}\"", chasm::options::arg<std::string>("dis-mode"));
+
+		return *mode;
+	}
+
+	void disassemble_batch(const std::vector<std::string>& arguments)
+	{
+		using clock = std::chrono::steady_clock;
+
+		const auto start = clock::now();
+		const auto inputs = chasm::ds::expand_batch(arguments);
+
+		std::optional<std::filesystem::path> output_dir;
+
+		if (chasm::options::has_flag("dis-out-dir"))
+			output_dir = chasm::options::arg<std::string>("dis-out-dir");
+
+		const auto batch = chasm::ds::disassembly_batch(chasm::options::arg<chasm::arch::addr>("relocate"),
+														disassembly_mode(),
+														std::move(output_dir));
+		const auto results = [&]
+		{
+			chasm::passes::scoped_pass pass("disassemble");
+			return batch.run(inputs, chasm::options::arg<unsigned int>("jobs"));
+		}();
+
+		const auto failed = std::ranges::count_if(results, [](const chasm::ds::batch_result& result) { return result.error.has_value(); });
+
+		for (const auto& result : results)
+			if (result.error)
+				chasm::log::warn("Could not disassemble {}: {}", result.rom.string(), *result.error);
+
+		if (chasm::options::has_flag("dis-report"))
+		{
+			std::ostringstream report;
+			chasm::ds::disassembly_batch::write_report(report, results);
+
+			io::write(chasm::options::arg<std::string>("dis-report"), report.str());
+		}
+
+		const auto elapsed = std::chrono::duration<double, std::milli>(clock::now() - start);
+
+		chasm::log::info("Disassembled {} of {} ROMs in {:.3f} ms, {} failed",
+						 results.size() - static_cast<size_t>(failed),
+						 results.size(),
+						 elapsed.count(),
+						 failed);
+	}
+
+	void write_trace()
+	{
+		if (!chasm::trace::enabled())
+			return;
+
+		try
+		{
+			chasm::trace::write(chasm::options::arg<std::string>("trace-out"));
+		}
+		catch (std::exception& error)
+		{
+			chasm::log::error(error.what());
+		}
+	}
+
+	void report_passes()
+	{
+		write_trace();
+
+		if (!chasm::passes::enabled())
+			return;
+
+		if (chasm::options::has_flag("time-passes"))
+			chasm::passes::report();
+
+		if (chasm::options::has_flag("time-passes-json"))
+			io::write(chasm::options::arg<std::string>("time-passes-json"), chasm::passes::to_json());
+
+		chasm::passes::clear();
+	}
+
+	[[noreturn]] void watch(const std::string& ifile, const std::string& ofile, chasm::incremental_state incremental)
+	{
+		using clock = std::chrono::steady_clock;
+
+		const auto debounce = std::chrono::milliseconds(chasm::options::arg<unsigned int>("watch-debounce"));
+
+		auto watcher = chasm::file_watcher(ifile);
+		std::optional<chasm::hasher::value_type> last_build;
+
+		for (;; watcher.wait_for_change(debounce))
+		{
+			const auto start = clock::now();
+
+			try
+			{
+				auto source = io::content(ifile);
+				const auto source_hash = chasm::hasher().update(source).digest();
+
+				//
+				// editors commonly save a buffer that did not change
+				//
+				if (source_hash == last_build)
+					continue;
+
+				assemble(std::move(source), ifile, ofile, &incremental);
+				last_build = source_hash;
+			}
+			catch (std::exception& error)
+			{
+				chasm::log::error(error.what());
+			}
+
+			const auto elapsed = std::chrono::duration<double, std::milli>(clock::now() - start);
+
+			report_passes();
+
+			chasm::log::info("Rebuild took {:.3f} ms, watching {} for changes...", elapsed.count(), ifile);
+			chasm::log::stream().flush();
 		}
 	}
 }
@@ -76,34 +494,73 @@ int main(int argc, char** argv)
 		if (chasm::options::has_flag("help"))
 			chasm::options::help();
 
+		const bool binary_to_stdout = chasm::is_stdio(chasm::options::arg<std::string>("out"));
+		const bool symbols_to_stdout = chasm::options::has_flag("symbols") && chasm::is_stdio(chasm::options::arg<std::string>("symbols"));
+
+		if (binary_to_stdout && symbols_to_stdout)
+			throw chasm::chasm_exception("The output file and the symbols file cannot both be written to the standard output");
+
+		const auto to_stdout = [](const std::string& option)
+		{
+			return chasm::options::has_flag(option) && chasm::is_stdio(chasm::options::arg<std::string>(option));
+		};
+
+		if (to_stdout("dis-out") && to_stdout("dis-dot"))
+			throw chasm::chasm_exception("The listing and the control flow graph cannot both be written to the standard output");
+
+		//
+		// without --dis-out the listing is printed to the standard output, right after the graph
+		//
+		if (to_stdout("dis-dot") && !chasm::options::has_flag("dis-out"))
+			throw chasm::chasm_exception("The control flow graph can only be written to the standard output along with --dis-out");
+
+		const bool listing_to_stdout = to_stdout("dis-out") || to_stdout("dis-dot");
+
+		chasm::log::use_stderr = binary_to_stdout || symbols_to_stdout || listing_to_stdout;
+
+		if (chasm::options::has_flag("time-passes") || chasm::options::has_flag("time-passes-json"))
+			chasm::passes::enable();
+
+		if (chasm::options::has_flag("trace-out"))
+		{
+			chasm::trace::enable();
+			chasm::trace::set_thread_name("main");
+		}
+
 		if (chasm::options::has_flag("in"))
 		{
 			const auto ifile = chasm::options::arg<std::string>("in");
 			const auto ofile = chasm::options::arg<std::string>("out");
 
-			auto lexer  = chasm::lexer(io::content(ifile));
-			auto tokens = lexer.enumerate_tokens();
+			std::optional<chasm::incremental_state> incremental;
 
-			if (tokens.empty())
-			{
-				chasm::log::warn("No input to be read.\n");
-				return EXIT_SUCCESS;
-			}
-
-			auto parser = chasm::parser(std::move(tokens));
-			auto ast = parser.make_tree();
-			const auto binary = ast.generate();
+			if (chasm::options::has_flag("incremental"))
+				incremental = chasm::incremental_state::load(chasm::options::arg<std::string>("incremental"));
 
-			if (chasm::options::has_flag("hex"))
-				io::hexdump(binary);
+			if (chasm::options::has_flag("watch") && chasm::is_stdio(ifile))
+				throw chasm::chasm_exception("The standard input cannot be watched for changes");
 
-			io::write(ofile, binary);
-
-			chasm::log::info("Build of file {} to {} finished", ifile, ofile);
+			if (chasm::options::has_flag("watch"))
+				build::watch(ifile, ofile, incremental ? std::move(*incremental) : chasm::incremental_state());
+			else
+				build::assemble(io::content(ifile), ifile, ofile, incremental ? &*incremental : nullptr);
+		}
+		else if (chasm::options::has_flag("project"))
+		{
+			build::project(chasm::options::arg<std::string>("project"));
+		}
+		else if (chasm::options::has_flag("link"))
+		{
+			build::link(chasm::options::arg<std::vector<std::string>>("link"), chasm::options::arg<std::string>("out"));
+		}
+		else if (chasm::options::has_flag("dis-batch"))
+		{
+			build::disassemble_batch(chasm::options::arg<std::vector<std::string>>("dis-batch"));
 		}
 		else if (chasm::options::has_flag("dis"))
     	{
-			auto bytes = io::bytes(chasm::options::arg<std::string>("dis"));
+			const auto ifile = chasm::options::arg<std::string>("dis");
+			auto bytes = io::bytes(ifile);
 
 			if (bytes.empty())
 			{
@@ -111,15 +568,65 @@ int main(int argc, char** argv)
 				return EXIT_SUCCESS;
 			}
 
-			auto disassembler = chasm::ds::disassembler(std::move(bytes), chasm::options::arg<chasm::arch::addr>("relocate"));
-			auto interface = chasm::ds::disassembly_interface(disassembler.get_graph());
-			interface.run();
+			const auto mode = build::disassembly_mode();
+
+			const auto base = chasm::options::arg<chasm::arch::addr>("relocate");
+
+			//
+			// the control flow is built from the opcodes the disassembler predecoded, so it is kept until then
+			//
+			std::optional<chasm::ds::disassembler> disassembler;
+
+			{
+				chasm::passes::scoped_pass pass("disassemble");
+				disassembler.emplace(std::move(bytes), base, mode, chasm::options::arg<unsigned int>("dis-threads"));
+			}
+
+			const bool show_blocks = chasm::options::has_flag("dis-cfg");
+			std::optional<chasm::ds::program_flow> flow;
+
+			if (show_blocks || chasm::options::has_flag("dis-dot"))
+			{
+				chasm::passes::scoped_pass pass("control flow");
+				flow = chasm::ds::build_program_flow(disassembler->get_opcodes(), base, base, disassembler->get_graph());
+			}
+
+			auto graph = std::move(*disassembler).get_graph();
+			disassembler.reset();
+
+			if (chasm::options::has_flag("dis-dot"))
+				io::write(chasm::options::arg<std::string>("dis-dot"), chasm::ds::export_dot(*flow));
+
+			if (chasm::options::has_flag("dis-out"))
+			{
+				const auto listing = [&]
+				{
+					chasm::passes::scoped_pass pass("render");
+					return chasm::ds::render_listing(graph, show_blocks ? &*flow : nullptr);
+				}();
+
+				io::write(chasm::options::arg<std::string>("dis-out"), listing);
+			}
+			else
+			{
+				auto interface = chasm::ds::disassembly_interface(std::move(graph), show_blocks ? std::move(flow) : std::nullopt);
+
+				//
+				// the binary consumed the standard input, no commands can follow
+				//
+				if (chasm::is_stdio(ifile))
+					interface.print_disassembly();
+				else
+					interface.run();
+			}
     	}
 		else
 		{
 			chasm::options::help();
 			return EXIT_FAILURE;
 		}
+
+		build::report_passes();
 	}
 	catch (cxxopts::exceptions::exception& error)
 	{
@@ -131,6 +638,12 @@ int main(int argc, char** argv)
 	catch (std::exception& error)
 	{
 		chasm::log::error(error.what());
+
+		//
+		// the trace also shows which files failed and when
+		//
+		build::write_trace();
+
 		return EXIT_FAILURE;
 	}
 
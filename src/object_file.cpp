@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <limits>
+
+#include <chasm/object_file.hpp>
+#include <chasm/chasm_exception.hpp>
+#include <chasm/binary_io.hpp>
+#include <chasm/version.hpp>
+
+
+namespace chasm
+{
+	namespace
+	{
+		constexpr std::string_view OBJECT_MAGIC = "C8O";
+		constexpr uint8_t OBJECT_FORMAT = 1;
+
+		void write_symbols(binary_writer& writer, const std::vector<object_file::symbol>& symbols)
+		{
+			writer.write(static_cast<uint32_t>(symbols.size()));
+
+			for (const auto& [name, offset] : symbols)
+				writer.write(std::string_view(name)).write(offset);
+		}
+
+		std::vector<object_file::symbol> read_symbols(binary_reader& reader)
+		{
+			std::vector<object_file::symbol> symbols(reader.read<uint32_t>());
+
+			for (auto& [name, offset] : symbols)
+			{
+				name = reader.read_string();
+				offset = reader.read<arch::size_type>();
+			}
+
+			return symbols;
+		}
+	}
+
+	bool object_file::defines_entry_point() const
+	{
+		return std::ranges::contains(locals, ".main", &symbol::name);
+	}
+
+	std::vector<uint8_t> object_file::serialize() const
+	{
+		binary_writer writer;
+
+		writer.write_raw(std::span(reinterpret_cast<const uint8_t*>(OBJECT_MAGIC.data()), OBJECT_MAGIC.size()))
+			  .write(OBJECT_FORMAT)
+			  .write(version)
+			  .write(code);
+
+		write_symbols(writer, exports);
+		write_symbols(writer, locals);
+
+		writer.write(static_cast<uint32_t>(imports.size()));
+
+		for (const auto& name : imports)
+			writer.write(std::string_view(name));
+
+		writer.write(static_cast<uint32_t>(relocations.size()));
+
+		for (const auto& [location, symbol] : relocations)
+			writer.write(location).write(std::string_view(symbol));
+
+		return writer.release();
+	}
+
+	object_file object_file::deserialize(std::span<const uint8_t> bytes)
+	{
+		binary_reader reader(bytes);
+
+		const auto magic = reader.read_raw(OBJECT_MAGIC.size());
+
+		if (!std::ranges::equal(magic, OBJECT_MAGIC))
+			throw chasm_exception("File is not a chasm object file.");
+
+		if (const auto format = reader.read<uint8_t>(); format != OBJECT_FORMAT)
+			throw chasm_exception("Unsupported object file format {}, expected format {}.", format, OBJECT_FORMAT);
+
+		//
+		// the producing version is informative only, the format number guards compatibility
+		//
+		(void) reader.read_string();
+
+		object_file object;
+
+		const auto code = reader.read_bytes();
+		object.code.assign(code.begin(), code.end());
+
+		object.exports = read_symbols(reader);
+		object.locals = read_symbols(reader);
+
+		object.imports.resize(reader.read<uint32_t>());
+
+		for (auto& name : object.imports)
+			name = reader.read_string();
+
+		object.relocations.resize(reader.read<uint32_t>());
+
+		for (auto& [location, symbol] : object.relocations)
+		{
+			location = reader.read<arch::size_type>();
+			symbol = reader.read_string();
+
+			if (location + sizeof(arch::opcode) > object.code.size())
+				throw chasm_exception("Relocation of symbol \"{}\" at {:x} is outside of the object code.", symbol, location);
+		}
+
+		return object;
+	}
+
+	void apply_relocation(std::span<uint8_t> code, size_t location, std::string_view symbol, uintptr_t address)
+	{
+		if (address > std::numeric_limits<arch::addr>::max())
+			throw chasm_exception("Symbol \"{}\" relocated to address {:x} which is out of the chip8's memory range.\n"
+								  "Assembler cannot generate address patch at {:x}",
+								  symbol,
+								  address,
+								  location);
+
+		code[location + 0] |= ((static_cast<arch::addr>(address) & 0x0F00) >> 8);
+		code[location + 1] |= ((static_cast<arch::addr>(address) & 0x00FF));
+	}
+}
@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <format>
+#include <array>
+
+#include <chasm/output_format.hpp>
+#include <chasm/chasm_exception.hpp>
+#include <chasm/file_io.hpp>
+
+
+namespace chasm::output
+{
+	namespace
+	{
+		//
+		// Two uppercase digits of every byte value, a byte is encoded with a single lookup
+		//
+		constexpr auto HEX_PAIRS = []
+		{
+			constexpr std::string_view digits = "0123456789ABCDEF";
+
+			std::array<std::array<char, 2>, 256> pairs {};
+
+			for (size_t i = 0; i < pairs.size(); ++i)
+				pairs[i] = { digits[i >> 4], digits[i & 0xF] };
+
+			return pairs;
+		}();
+
+		constexpr std::string_view BASE64_DIGITS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+		//
+		// Writes through a cursor into a buffer sized before encoding starts
+		//
+		class encoder
+		{
+		public:
+			explicit encoder(size_t size)
+			{
+				buffer.resize(size);
+				cursor = buffer.data();
+			}
+
+			void put(char c)
+			{
+				*cursor++ = c;
+			}
+
+			void put(std::string_view str)
+			{
+				cursor = std::ranges::copy(str, cursor).out;
+			}
+
+			void put_hex(uint8_t byte)
+			{
+				cursor = std::ranges::copy(HEX_PAIRS[byte], cursor).out;
+			}
+
+			//
+			// big endian, as many digits as the value type holds
+			//
+			template<typename T>
+			void put_hex_value(T value)
+			{
+				for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8)
+					put_hex(static_cast<uint8_t>(value >> shift));
+			}
+
+			[[nodiscard]] std::string finish() &&
+			{
+				buffer.resize(cursor - buffer.data());
+				return std::move(buffer);
+			}
+
+		private:
+			std::string buffer;
+			char* cursor = nullptr;
+		};
+
+		std::string encode_raw(std::span<const uint8_t> binary, const encode_parameters&)
+		{
+			return { binary.begin(), binary.end() };
+		}
+
+		//
+		// Data records of 16 bytes, preceded by an extended linear address record
+		// whenever the upper 16 bits of the address change
+		//
+		std::string encode_ihex(std::span<const uint8_t> binary, const encode_parameters& params)
+		{
+			constexpr size_t RECORD_SIZE = 16;
+			constexpr std::string_view END_OF_FILE = ":00000001FF\n";
+
+			// ':' + count + address + type + data + checksum + '\n', at worst one address record per data record
+			constexpr size_t DATA_RECORD_LENGTH = 1 + 2 + 4 + 2 + RECORD_SIZE * 2 + 2 + 1;
+			constexpr size_t ADDRESS_RECORD_LENGTH = 1 + 2 + 4 + 2 + 4 + 2 + 1;
+
+			const auto records = (binary.size() + RECORD_SIZE - 1) / RECORD_SIZE;
+			auto out = encoder(records * (DATA_RECORD_LENGTH + ADDRESS_RECORD_LENGTH) + END_OF_FILE.size());
+
+			auto record = [&out](uint8_t type, uint16_t address, std::span<const uint8_t> data)
+			{
+				auto checksum = static_cast<uint8_t>(data.size() + (address >> 8) + (address & 0xFF) + type);
+
+				out.put(':');
+				out.put_hex(static_cast<uint8_t>(data.size()));
+				out.put_hex_value(address);
+				out.put_hex(type);
+
+				for (const auto byte : data)
+				{
+					out.put_hex(byte);
+					checksum += byte;
+				}
+
+				out.put_hex(static_cast<uint8_t>(-checksum));
+				out.put('\n');
+			};
+
+			std::optional<uint16_t> upper_address;
+
+			for (size_t offset = 0; offset < binary.size(); offset += RECORD_SIZE)
+			{
+				const auto address = static_cast<uint32_t>(params.base + offset);
+				const auto upper = static_cast<uint16_t>(address >> 16);
+
+				if (upper_address != upper && (upper != 0 || upper_address))
+				{
+					const std::array<uint8_t, 2> segment { static_cast<uint8_t>(upper >> 8), static_cast<uint8_t>(upper) };
+					record(0x04, 0, segment);
+				}
+
+				upper_address = upper;
+				record(0x00, static_cast<uint16_t>(address), binary.subspan(offset, std::min(RECORD_SIZE, binary.size() - offset)));
+			}
+
+			out.put(END_OF_FILE);
+
+			return std::move(out).finish();
+		}
+
+		std::string encode_c_array(std::span<const uint8_t> binary, const encode_parameters& params)
+		{
+			constexpr size_t BYTES_PER_LINE = 12;
+
+			const auto header = std::format("#include <stddef.h>\n\n"
+											"static const unsigned char {}[] = {{\n",
+											params.array_name);
+
+			const auto footer = std::format("}};\n\n"
+											"static const size_t {}_size = {};\n",
+											params.array_name,
+											binary.size());
+
+			// "\t" + "0xXX, " per byte + "\n"
+			const auto lines = (binary.size() + BYTES_PER_LINE - 1) / BYTES_PER_LINE;
+			auto out = encoder(header.size() + lines * 2 + binary.size() * 6 + footer.size());
+
+			out.put(header);
+
+			for (size_t i = 0; i < binary.size(); ++i)
+			{
+				if (i % BYTES_PER_LINE == 0)
+					out.put('\t');
+
+				out.put("0x");
+				out.put_hex(binary[i]);
+
+				const bool last_of_line = i % BYTES_PER_LINE == BYTES_PER_LINE - 1 || i + 1 == binary.size();
+
+				out.put(last_of_line ? ",\n" : ", ");
+			}
+
+			out.put(footer);
+
+			return std::move(out).finish();
+		}
+
+		std::string encode_base64(std::span<const uint8_t> binary, const encode_parameters&)
+		{
+			auto out = encoder((binary.size() + 2) / 3 * 4 + 1);
+
+			size_t i = 0;
+
+			for (; i + 3 <= binary.size(); i += 3)
+			{
+				const uint32_t triplet = binary[i] << 16 | binary[i + 1] << 8 | binary[i + 2];
+
+				out.put(BASE64_DIGITS[triplet >> 18 & 0x3F]);
+				out.put(BASE64_DIGITS[triplet >> 12 & 0x3F]);
+				out.put(BASE64_DIGITS[triplet >> 6 & 0x3F]);
+				out.put(BASE64_DIGITS[triplet & 0x3F]);
+			}
+
+			if (const auto remaining = binary.size() - i; remaining > 0)
+			{
+				const uint32_t triplet = binary[i] << 16 | (remaining == 2 ? binary[i + 1] << 8 : 0);
+
+				out.put(BASE64_DIGITS[triplet >> 18 & 0x3F]);
+				out.put(BASE64_DIGITS[triplet >> 12 & 0x3F]);
+				out.put(remaining == 2 ? BASE64_DIGITS[triplet >> 6 & 0x3F] : '=');
+				out.put('=');
+			}
+
+			out.put('\n');
+
+			return std::move(out).finish();
+		}
+
+		std::string encode_hexdump(std::span<const uint8_t> binary, const encode_parameters& params)
+		{
+			const size_t per_line = std::max(params.bytes_per_line, 1u);
+			const auto lines = (binary.size() + per_line - 1) / per_line;
+
+			// "0xAAAA: " + "XX " per byte + "\n", addresses past 0xFFFF take up to 4 more digits
+			auto out = encoder(lines * (2 + 8 + 2 + 1) + binary.size() * 3);
+
+			for (size_t line = 0; line < binary.size(); line += per_line)
+			{
+				const auto address = static_cast<uint32_t>(params.base + line);
+
+				out.put("0x");
+
+				if (address > 0xFFFF)
+					out.put_hex_value(static_cast<uint16_t>(address >> 16));
+
+				out.put_hex_value(static_cast<uint16_t>(address));
+				out.put(": ");
+
+				for (const auto byte : binary.subspan(line, std::min(per_line, binary.size() - line)))
+				{
+					out.put_hex(byte);
+					out.put(' ');
+				}
+
+				out.put('\n');
+			}
+
+			return std::move(out).finish();
+		}
+
+		struct format_entry
+		{
+			format fmt;
+			std::string_view name;
+			std::string_view extension;
+			std::string (*encode)(std::span<const uint8_t>, const encode_parameters&);
+		};
+
+		constexpr std::array FORMATS
+		{
+			format_entry { format::raw,     "raw",     ".c8c", encode_raw     },
+			format_entry { format::ihex,    "ihex",    ".hex", encode_ihex    },
+			format_entry { format::c_array, "c",       ".h",   encode_c_array },
+			format_entry { format::base64,  "base64",  ".b64", encode_base64  },
+			format_entry { format::hexdump, "hexdump", ".txt", encode_hexdump }
+		};
+
+		static_assert(std::ranges::all_of(FORMATS, [](const format_entry& e)
+		{
+			return &e - FORMATS.data() == static_cast<std::ptrdiff_t>(e.fmt);
+		}), "Formats must be listed in the order of the enumeration");
+
+		const format_entry& entry(format fmt)
+		{
+			return FORMATS[static_cast<size_t>(fmt)];
+		}
+	}
+
+	std::optional<format> parse_format(std::string_view name)
+	{
+		const auto it = std::ranges::find(FORMATS, name, &format_entry::name);
+
+		if (it == FORMATS.end())
+			return std::nullopt;
+
+		return it->fmt;
+	}
+
+	std::string_view name(format fmt)
+	{
+		return entry(fmt).name;
+	}
+
+	std::string_view extension(format fmt)
+	{
+		return entry(fmt).extension;
+	}
+
+	std::string encode(format fmt, std::span<const uint8_t> binary, const encode_parameters& params)
+	{
+		return entry(fmt).encode(binary, params);
+	}
+
+	std::vector<output_file> output_files(const std::filesystem::path& ofile, std::span<const std::string> formats)
+	{
+		std::vector<output_file> files;
+
+		for (const auto& format_name : formats)
+		{
+			const auto fmt = parse_format(format_name);
+
+			if (!fmt)
+				throw chasm_exception("Unknown output format \"{}\"", format_name);
+
+			if (!files.empty() && is_stdio(ofile))
+				throw chasm_exception("Only one output format can be written to the standard output");
+
+			auto path = files.empty() ? ofile : std::filesystem::path(ofile).replace_extension(extension(*fmt));
+
+			for (const auto& previous : files)
+			{
+				if (previous.fmt == *fmt)
+					throw chasm_exception("Output format \"{}\" is given more than once", format_name);
+
+				if (previous.path == path)
+					throw chasm_exception("Output formats \"{}\" and \"{}\" would both be written to {}",
+										  name(previous.fmt),
+										  format_name,
+										  path.string());
+			}
+
+			files.push_back({ *fmt, std::move(path) });
+		}
+
+		return files;
+	}
+}
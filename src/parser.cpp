@@ -7,42 +7,64 @@ namespace chasm
 {
 
     parser::parser(std::vector<token> &&tokens_list)
-        : tokens(std::move(tokens_list)),
-		  token_it(std::begin(tokens))
+        : tokens(std::move(tokens_list))
     {}
 
+	parser::parser(token_source source_)
+		: source(std::move(source_))
+	{}
+
 	token parser::advance()
 	{
 		if (no_more_tokens())
 			throw chasm_exception("Expected more tokens before end of file.");
 
-		const token t = *token_it;
-		++token_it;
+		if (!source)
+			return std::move(tokens[token_index++]);
+
+		token t = std::move(*lookahead);
+		lookahead.reset();
 
 		return t;
 	}
 
-    bool parser::no_more_tokens() const
+	const token* parser::peek()
+	{
+		if (!source)
+			return token_index < tokens.size() ? &tokens[token_index] : nullptr;
+
+		if (!lookahead)
+			lookahead = source();
+
+		return lookahead ? &*lookahead : nullptr;
+	}
+
+    bool parser::no_more_tokens()
     {
-        return token_it == std::end(tokens);
+        return peek() == nullptr;
     }
 
     ast::abstract_tree parser::make_tree()
     {
 		std::vector<ast::statement> branches;
 
-		while (auto branch = parse_primary_statement())
+		while (auto branch = next_statement())
 			branches.push_back(std::move(branch));
 
         return ast::abstract_tree(std::move(branches));
     }
 
+	ast::statement parser::next_statement()
+	{
+		return parse_primary_statement();
+	}
+
 	ast::statement parser::parse_primary_statement()
 	{
 		if (no_more_tokens())
 			return {};
 
-		switch (token_it->type)
+		switch (peek()->type)
 		{
 			case token_type::keyword_define:     return parse_define();
 			case token_type::keyword_config:     return parse_config();
@@ -53,7 +75,7 @@ namespace chasm
 			case token_type::instruction:        return parse_instruction();
 
 			default:
-				throw parser_exception::unexpected_error(*token_it);
+				throw parser_exception::unexpected_error(*peek());
 		}
 	}
 
@@ -173,7 +195,7 @@ namespace chasm
 			if (no_more_tokens())
 				throw chasm_exception("Found unexpected EOF before function end while parsing procedure.");
 
-			switch (token_it->type)
+			switch (peek()->type)
 			{
 				case token_type::keyword_proc_end: return {};
 				case token_type::keyword_define:   return parse_define();
@@ -186,7 +208,7 @@ namespace chasm
 					throw chasm_exception("Cannot define a procedure inside another.");
 
 				default:
-					throw parser_exception::unexpected_error(*token_it);
+					throw parser_exception::unexpected_error(*peek());
 			}
 		};
 
@@ -201,7 +223,7 @@ namespace chasm
 		expect(token_type::keyword_proc_end);
 		auto proc_name_end = expect(token_type::identifier);
 
-		if (proc_name_end.data != proc_name_beg.data)
+		if (proc_name_end.text() != proc_name_beg.text())
 			throw parser_exception::unmatching_procedure_names(proc_name_beg, proc_name_end);
 
 		return std::make_unique<ast::procedure_statement>(
@@ -218,7 +240,7 @@ namespace chasm
 			if (no_more_tokens())
 				return {};
 
-			switch (token_it->type)
+			switch (peek()->type)
 			{
 				case token_type::keyword_proc_end:
 				case token_type::dot_label:
@@ -230,7 +252,7 @@ namespace chasm
 				case token_type::instruction:    return parse_instruction();
 
 				default:
-					throw parser_exception::unexpected_error(*token_it);
+					throw parser_exception::unexpected_error(*peek());
 			}
 		};
 
@@ -0,0 +1,255 @@
+#include <cstdlib>
+#include <atomic>
+#include <format>
+#include <ctime>
+#include <mutex>
+#include <new>
+
+#include <chasm/pass_timer.hpp>
+#include <chasm/version.hpp>
+#include <chasm/json.hpp>
+#include <chasm/log.hpp>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+
+namespace
+{
+	//
+	// only set while passes are measured, other allocations cost a single relaxed load
+	//
+	std::atomic<bool> counting = false;
+
+	std::atomic<uint64_t> allocation_count = 0;
+	std::atomic<uint64_t> allocated_bytes = 0;
+
+	void count_allocation(size_t size)
+	{
+		if (!counting.load(std::memory_order_relaxed))
+			return;
+
+		allocation_count.fetch_add(1, std::memory_order_relaxed);
+		allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	void* counted_allocation(size_t size)
+	{
+		count_allocation(size);
+
+		//
+		// malloc(0) may return a null pointer, operator new must not
+		//
+		if (void* p = std::malloc(size == 0 ? 1 : size))
+			return p;
+
+		throw std::bad_alloc();
+	}
+
+	void* counted_aligned_allocation(size_t size, std::align_val_t alignment)
+	{
+		count_allocation(size);
+
+		const auto align = static_cast<size_t>(alignment);
+
+		// aligned_alloc needs a size multiple of the alignment
+		const auto rounded = (size + align - 1) / align * align;
+
+#ifdef _WIN32
+		void* p = _aligned_malloc(rounded == 0 ? align : rounded, align);
+#else
+		void* p = std::aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+
+		if (p)
+			return p;
+
+		throw std::bad_alloc();
+	}
+}
+
+
+//
+// Counting allocator hook: the default array, nothrow and sized forms forward to these
+//
+void* operator new(size_t size)
+{
+	return counted_allocation(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return counted_aligned_allocation(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+
+namespace chasm::passes
+{
+	namespace
+	{
+		std::atomic<bool> is_enabled = false;
+
+		std::mutex records_mutex;
+		std::vector<pass_record> measured;
+
+		thread_local size_t current_depth = 0;
+
+		double cpu_time_ms()
+		{
+			return static_cast<double>(std::clock()) * 1000.0 / CLOCKS_PER_SEC;
+		}
+
+		uint64_t peak_rss_kib()
+		{
+#ifdef __unix__
+			rusage usage {};
+
+			if (getrusage(RUSAGE_SELF, &usage) == 0)
+				return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+			return 0;
+		}
+	}
+
+	allocation_stats allocations()
+	{
+		return {
+			.count = allocation_count.load(std::memory_order_relaxed),
+			.bytes = allocated_bytes.load(std::memory_order_relaxed)
+		};
+	}
+
+	void enable(bool on)
+	{
+		is_enabled.store(on, std::memory_order_relaxed);
+		counting.store(on, std::memory_order_relaxed);
+	}
+
+	bool enabled()
+	{
+		return is_enabled.load(std::memory_order_relaxed);
+	}
+
+	std::vector<pass_record> records()
+	{
+		std::scoped_lock lock(records_mutex);
+		return measured;
+	}
+
+	void clear()
+	{
+		std::scoped_lock lock(records_mutex);
+		measured.clear();
+	}
+
+	void report()
+	{
+		log::info("{:<24} {:>11} {:>11} {:>10} {:>14} {:>14}", "Pass", "Wall (ms)", "CPU (ms)", "Allocs", "Alloc bytes", "Peak RSS (KiB)");
+
+		for (const auto& r : records())
+			log::info("{:<24} {:>11.3f} {:>11.3f} {:>10} {:>14} {:>14}",
+					  std::string(r.depth * 2, ' ') + r.name,
+					  r.wall_ms,
+					  r.cpu_ms,
+					  r.allocation_count,
+					  r.allocated_bytes,
+					  r.peak_rss_kib);
+	}
+
+	std::string to_json()
+	{
+		std::string json = std::format("{{\n  \"version\": \"{}\",\n  \"passes\": [", version);
+
+		const auto passes = records();
+
+		for (size_t i = 0; i < passes.size(); ++i)
+		{
+			const auto& r = passes[i];
+
+			std::format_to(std::back_inserter(json),
+						   "{}\n    {{ \"name\": \"{}\", \"depth\": {}, \"wall_ms\": {:.3f}, \"cpu_ms\": {:.3f}, "
+						   "\"allocations\": {}, \"allocated_bytes\": {}, \"peak_rss_kib\": {} }}",
+						   i == 0 ? "" : ",",
+						   json::escaped(r.name),
+						   r.depth,
+						   r.wall_ms,
+						   r.cpu_ms,
+						   r.allocation_count,
+						   r.allocated_bytes,
+						   r.peak_rss_kib);
+		}
+
+		json += "\n  ]\n}\n";
+
+		return json;
+	}
+
+	scoped_pass::scoped_pass(std::string_view name_)
+		: span(name_, "pass"),
+		  active(enabled())
+	{
+		if (!active)
+			return;
+
+		{
+			std::scoped_lock lock(records_mutex);
+
+			slot = measured.size();
+			measured.push_back({ .name = std::string(name_), .depth = current_depth });
+		}
+
+		++current_depth;
+
+		allocations_start = allocations();
+		cpu_start = cpu_time_ms();
+		wall_start = std::chrono::steady_clock::now();
+	}
+
+	scoped_pass::~scoped_pass()
+	{
+		if (!active)
+			return;
+
+		const auto wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start);
+		const auto cpu = cpu_time_ms() - cpu_start;
+		const auto allocated = allocations();
+
+		--current_depth;
+
+		std::scoped_lock lock(records_mutex);
+
+		//
+		// the records were cleared while the pass was running
+		//
+		if (slot >= measured.size())
+			return;
+
+		auto& r = measured[slot];
+
+		r.wall_ms = wall.count();
+		r.cpu_ms = cpu;
+		r.allocation_count = allocated.count - allocations_start.count;
+		r.allocated_bytes = allocated.bytes - allocations_start.bytes;
+		r.peak_rss_kib = peak_rss_kib();
+	}
+}
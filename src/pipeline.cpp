@@ -0,0 +1,138 @@
+#include <exception>
+#include <thread>
+#include <mutex>
+
+#include <chasm/pipeline.hpp>
+#include <chasm/symbol_sanitizer.hpp>
+#include <chasm/spsc_queue.hpp>
+#include <chasm/generator.hpp>
+#include <chasm/parser.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/trace.hpp>
+
+
+namespace chasm
+{
+	namespace
+	{
+		constexpr size_t TOKEN_QUEUE_SIZE = 1024;
+		constexpr size_t STATEMENT_QUEUE_SIZE = 128;
+	}
+
+	std::vector<uint8_t> assemble_pipelined(std::string&& source)
+	{
+		spsc_queue<token, TOKEN_QUEUE_SIZE> tokens;
+		spsc_queue<ast::statement, STATEMENT_QUEUE_SIZE> statements;
+
+		//
+		// A failing stage records its error then aborts both queues so the others stop waiting.
+		// Stages cut short by the abort may fail in turn, only the first error is reported.
+		//
+		std::mutex error_mutex;
+		std::exception_ptr first_error;
+
+		auto fail = [&]
+		{
+			{
+				std::scoped_lock lock(error_mutex);
+
+				if (!first_error)
+					first_error = std::current_exception();
+			}
+
+			tokens.abort();
+			statements.abort();
+		};
+
+		std::jthread lexing([&]
+		{
+			trace::set_thread_name("lexer");
+			trace::scoped_span span("lex", "stage");
+
+			try
+			{
+				auto lex = lexer(std::move(source));
+
+				lex.enumerate_tokens([&](token&& t)
+				{
+					return tokens.push(std::move(t));
+				});
+			}
+			catch (...)
+			{
+				fail();
+			}
+
+			tokens.close();
+		});
+
+		std::jthread parsing([&]
+		{
+			trace::set_thread_name("parser");
+			trace::scoped_span span("parse", "stage");
+
+			try
+			{
+				auto par = parser([&] { return tokens.pop(); });
+
+				while (auto statement = par.next_statement())
+					if (!statements.push(std::move(statement)))
+						break;
+			}
+			catch (...)
+			{
+				fail();
+			}
+
+			statements.close();
+		});
+
+		std::vector<uint8_t> binary;
+
+		try
+		{
+			trace::scoped_span span("generate", "stage");
+
+			symbol_sanitizer sanitizer;
+			generator generator;
+
+			//
+			// nothing is generated before the whole source is sanitized, as abstract_tree::generate does
+			//
+			std::vector<ast::statement> top_level;
+			std::vector<ast::statement> procedures;
+
+			while (auto statement = statements.pop())
+			{
+				(*statement)->accept(sanitizer);
+
+				if ((*statement)->priority() == ast::statement_priority::procedure)
+					procedures.push_back(std::move(*statement));
+				else
+					top_level.push_back(std::move(*statement));
+			}
+
+			sanitizer.finalize();
+
+			for (const auto& statement : top_level)
+				statement->accept(generator);
+
+			for (const auto& procedure : procedures)
+				procedure->accept(generator);
+
+			binary = generator.finalize();
+		}
+		catch (...)
+		{
+			fail();
+		}
+
+		lexing.join();
+		parsing.join();
+
+		if (first_error)
+			std::rethrow_exception(first_error);
+
+		return binary;
+	}
+}
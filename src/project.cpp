@@ -0,0 +1,433 @@
+#include <condition_variable>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <deque>
+
+#include <chasm/project.hpp>
+#include <chasm/chasm_exception.hpp>
+#include <chasm/object_file.hpp>
+#include <chasm/generator.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/options.hpp>
+#include <chasm/version.hpp>
+#include <chasm/linker.hpp>
+#include <chasm/parser.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/pass_timer.hpp>
+#include <chasm/trace.hpp>
+#include <chasm/log.hpp>
+
+
+namespace chasm
+{
+	namespace
+	{
+		constexpr std::string_view OBJECT_EXT = ".c8o";
+		constexpr std::string_view STAMP_EXT  = ".stamp";
+
+		std::string read_source(const project::module& module)
+		{
+			const auto file = mapped_file::open(module.source);
+
+			if (!file)
+				throw chasm_exception("Could not open source file {} of module {}", module.source.string(), module.name);
+
+			const auto bytes = file->bytes();
+
+			return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+		}
+
+		std::vector<std::string_view> split_words(std::string_view line)
+		{
+			std::vector<std::string_view> words;
+
+			while (!line.empty())
+			{
+				const auto begin = line.find_first_not_of(" \t\r");
+
+				if (begin == std::string_view::npos)
+					break;
+
+				line.remove_prefix(begin);
+
+				const auto end = std::min(line.find_first_of(" \t\r"), line.size());
+
+				words.push_back(line.substr(0, end));
+				line.remove_prefix(end);
+			}
+
+			return words;
+		}
+	}
+
+	project project::load(const std::filesystem::path& manifest)
+	{
+		const auto file = mapped_file::open(manifest);
+
+		if (!file)
+			throw chasm_exception("Could not open project manifest {}", manifest.string());
+
+		const auto bytes = file->bytes();
+
+		return parse({ reinterpret_cast<const char*>(bytes.data()), bytes.size() }, manifest.parent_path());
+	}
+
+	project project::parse(std::string_view manifest, const std::filesystem::path& root)
+	{
+		project p;
+		size_t line_number = 0;
+
+		for (std::string_view rest = manifest; !rest.empty(); )
+		{
+			const auto eol = std::min(rest.find('\n'), rest.size());
+
+			auto line = rest.substr(0, eol);
+			rest.remove_prefix(std::min(eol + 1, rest.size()));
+			++line_number;
+
+			if (const auto comment = line.find(";;"); comment != std::string_view::npos)
+				line = line.substr(0, comment);
+
+			const auto words = split_words(line);
+
+			if (words.empty())
+				continue;
+
+			if (words[0] == "output" && words.size() == 2)
+			{
+				p.output_path = root / words[1];
+			}
+			else if (words[0] == "module" && words.size() >= 3)
+			{
+				if (std::ranges::contains(p.sorted_modules, words[1], &module::name))
+					throw chasm_exception("Module {} is declared twice in project manifest, line {}", words[1], line_number);
+
+				p.sorted_modules.push_back({
+					.name = std::string(words[1]),
+					.source = root / words[2],
+					.dependencies = { words.begin() + 3, words.end() }
+				});
+			}
+			else
+			{
+				throw chasm_exception("Invalid project manifest line {}, expected \"module <name> <source> [dependencies...]\" "
+									  "or \"output <path>\"", line_number);
+			}
+		}
+
+		if (p.sorted_modules.empty())
+			throw chasm_exception("Project manifest does not declare any module");
+
+		p.sort_modules();
+
+		return p;
+	}
+
+	const std::vector<project::module>& project::modules() const
+	{
+		return sorted_modules;
+	}
+
+	const std::optional<std::filesystem::path>& project::output() const
+	{
+		return output_path;
+	}
+
+	void project::sort_modules()
+	{
+		for (const auto& m : sorted_modules)
+			for (const auto& dependency : m.dependencies)
+				if (!std::ranges::contains(sorted_modules, dependency, &module::name))
+					throw chasm_exception("Module {} depends on undeclared module {}", m.name, dependency);
+
+		//
+		// Repeatedly take the first module (in manifest order) whose dependencies are all placed,
+		// so the order is stable from one build to the next
+		//
+		std::vector<module> sorted;
+		sorted.reserve(sorted_modules.size());
+
+		while (!sorted_modules.empty())
+		{
+			const auto next = std::ranges::find_if(sorted_modules, [&sorted](const module& m)
+			{
+				return std::ranges::all_of(m.dependencies, [&sorted](const std::string& dependency)
+				{
+					return std::ranges::contains(sorted, dependency, &module::name);
+				});
+			});
+
+			if (next == sorted_modules.end())
+			{
+				std::string cycle;
+
+				for (const auto& m : sorted_modules)
+					cycle += (cycle.empty() ? "" : ", ") + m.name;
+
+				throw chasm_exception("Modules {} depend on each other", cycle);
+			}
+
+			sorted.push_back(std::move(*next));
+			sorted_modules.erase(next);
+		}
+
+		sorted_modules = std::move(sorted);
+	}
+
+	size_t project::index_of(std::string_view name) const
+	{
+		return static_cast<size_t>(std::ranges::find(sorted_modules, name, &module::name) - sorted_modules.begin());
+	}
+
+	std::vector<hasher::value_type> project::module_keys() const
+	{
+		std::vector<hasher::value_type> keys;
+		keys.reserve(sorted_modules.size());
+
+		for (const auto& m : sorted_modules)
+		{
+			hasher h;
+
+			h.update(version)
+			 .update(options::has_flag("super"))
+			 .update(options::has_flag("pad-sprites"))
+			 .update(read_source(m));
+
+			//
+			// dependencies come first in the sorted modules, their key is already known
+			//
+			for (const auto& dependency : m.dependencies)
+				h.update(keys[index_of(dependency)]);
+
+			keys.push_back(h.digest());
+		}
+
+		return keys;
+	}
+
+	std::vector<uint8_t> project::build(const std::filesystem::path& build_dir, unsigned int jobs) const
+	{
+		using clock = std::chrono::steady_clock;
+
+		enum class module_state
+		{
+			pending,
+			up_to_date,
+			built,
+			failed,
+			skipped
+		};
+
+		std::filesystem::create_directories(build_dir);
+
+		const auto object_path = [&](const module& m) { return build_dir / (m.name + std::string(OBJECT_EXT)); };
+		const auto stamp_path  = [&](const module& m) { return build_dir / (m.name + std::string(STAMP_EXT)); };
+
+		const auto keys = module_keys();
+		const auto count = sorted_modules.size();
+
+		std::vector<module_state> states(count, module_state::pending);
+		std::vector<std::vector<size_t>> dependents(count);
+		std::vector<size_t> waiting_on(count, 0);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto& m = sorted_modules[i];
+			const auto stamp = mapped_file::open(stamp_path(m));
+			const auto expected = std::format("{:016x}", keys[i]);
+
+			if (stamp && std::filesystem::exists(object_path(m)) && std::ranges::equal(stamp->bytes(), expected))
+			{
+				states[i] = module_state::up_to_date;
+				log::info("Module {} is up to date", m.name);
+				trace::instant("cache hit", "cache", m.name);
+			}
+			else
+			{
+				trace::instant("cache miss", "cache", m.name);
+			}
+		}
+
+		std::deque<size_t> ready;
+		size_t unfinished = 0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (states[i] != module_state::pending)
+				continue;
+
+			++unfinished;
+
+			for (const auto& dependency : sorted_modules[i].dependencies)
+			{
+				const auto dep = index_of(dependency);
+
+				if (states[dep] == module_state::pending)
+				{
+					dependents[dep].push_back(i);
+					++waiting_on[i];
+				}
+			}
+
+			if (waiting_on[i] == 0)
+				ready.push_back(i);
+		}
+
+		std::mutex mutex;
+		std::condition_variable wake;
+
+		//
+		// Called with the mutex held, releases the dependents of a finished module
+		// and skips the ones depending on a failed module
+		//
+		const auto finish = [&](size_t finished, module_state state)
+		{
+			std::vector<std::pair<size_t, module_state>> done { { finished, state } };
+
+			while (!done.empty())
+			{
+				const auto [index, result] = done.back();
+				done.pop_back();
+
+				states[index] = result;
+				--unfinished;
+
+				for (const auto dependent : dependents[index])
+				{
+					if (--waiting_on[dependent] > 0)
+						continue;
+
+					const bool dependency_failed = std::ranges::any_of(sorted_modules[dependent].dependencies, [&](const std::string& dep)
+					{
+						const auto s = states[index_of(dep)];
+						return s == module_state::failed || s == module_state::skipped;
+					});
+
+					if (dependency_failed)
+					{
+						log::warn("Module {} skipped as one of its dependencies failed", sorted_modules[dependent].name);
+						done.emplace_back(dependent, module_state::skipped);
+					}
+					else
+					{
+						ready.push_back(dependent);
+					}
+				}
+			}
+
+			wake.notify_all();
+		};
+
+		const auto assemble = [&](size_t index)
+		{
+			const auto& m = sorted_modules[index];
+			const auto start = clock::now();
+
+			trace::scoped_span span("module", "file", m.name);
+
+			auto tokens = [&]
+			{
+				passes::scoped_pass pass("lex");
+
+				auto lexer = chasm::lexer(read_source(m));
+				return lexer.enumerate_tokens();
+			}();
+
+			auto tree = [&]
+			{
+				passes::scoped_pass pass("parse");
+
+				auto parser = chasm::parser(std::move(tokens));
+				return parser.make_tree();
+			}();
+
+			const auto object = tree.generate_object().serialize();
+
+			write_atomic(object_path(m), std::span(reinterpret_cast<const char*>(object.data()), object.size()));
+			write_atomic(stamp_path(m), std::format("{:016x}", keys[index]));
+
+			const auto elapsed = std::chrono::duration<double, std::milli>(clock::now() - start);
+
+			log::info("Module {} assembled in {:.3f} ms", m.name, elapsed.count());
+		};
+
+		const auto worker = [&](size_t worker_index)
+		{
+			trace::set_thread_name(std::format("worker {}", worker_index));
+
+			std::unique_lock lock(mutex);
+
+			for (;;)
+			{
+				{
+					trace::scoped_span idle("wait for module", "queue");
+					wake.wait(lock, [&] { return !ready.empty() || unfinished == 0; });
+				}
+
+				if (ready.empty())
+					return;
+
+				const auto index = ready.front();
+				ready.pop_front();
+
+				lock.unlock();
+
+				auto state = module_state::built;
+
+				try
+				{
+					assemble(index);
+				}
+				catch (const std::exception& error)
+				{
+					log::error("Module {} failed to assemble: {}", sorted_modules[index].name, error.what());
+					state = module_state::failed;
+				}
+
+				lock.lock();
+				finish(index, state);
+			}
+		};
+
+		if (jobs == 0)
+			jobs = std::max(1u, std::thread::hardware_concurrency());
+
+		{
+			std::vector<std::jthread> workers;
+
+			for (size_t i = 0; i < std::min<size_t>(jobs, unfinished); ++i)
+				workers.emplace_back(worker, i);
+		}
+
+		if (const auto failed = std::ranges::count(states, module_state::failed); failed > 0)
+			throw chasm_exception("{} of {} modules failed to assemble", failed, count);
+
+		//
+		// Every module object is up to date, link them
+		//
+		linker linker;
+
+		for (const auto& m : sorted_modules)
+		{
+			const auto object = mapped_file::open(object_path(m));
+
+			if (!object)
+				throw chasm_exception("Could not open object file of module {}", m.name);
+
+			linker.add(object_file::deserialize(object->bytes()), m.name);
+		}
+
+		auto binary = [&]
+		{
+			passes::scoped_pass pass("link");
+			return linker.link(options::arg<arch::addr>("relocate"));
+		}();
+
+		if (options::has_flag("symbols"))
+			generate_symbols_file(options::arg<std::string>("symbols"), linker.symbols());
+
+		return binary;
+	}
+}
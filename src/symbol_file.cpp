@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <fstream>
+#include <format>
+#include <tuple>
+
+#include <chasm/symbol_file.hpp>
+#include <chasm/chasm_exception.hpp>
+#include <chasm/binary_io.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/options.hpp>
+#include <chasm/log.hpp>
+
+
+namespace chasm
+{
+	namespace
+	{
+		constexpr std::string_view INDEX_MAGIC = "C8S";
+		constexpr uint8_t INDEX_FORMAT = 1;
+
+		// magic + format, base, symbols count, lines count, pool size
+		constexpr size_t HEADER_SIZE = 4 + 4 * 4;
+
+		// address, name offset, name size
+		constexpr size_t SYMBOL_ENTRY_SIZE = 3 * 4;
+
+		// address, line
+		constexpr size_t LINE_ENTRY_SIZE = 2 * 4;
+
+		//
+		// Sort from lowest to highest address, symbols sharing an address by name
+		//
+		std::vector<std::pair<std::string_view, arch::addr>> sorted_symbols(const symbol_map& symbols)
+		{
+			std::vector<std::pair<std::string_view, arch::addr>> elems(symbols.begin(), symbols.end());
+
+			std::ranges::sort(elems, [](const auto& a, const auto& b)
+			{
+				return std::tie(a.second, a.first) < std::tie(b.second, b.first);
+			});
+
+			return elems;
+		}
+
+		//
+		// Greatest index whose address is not above the given one, entries are sorted by address
+		//
+		template<typename AddressOf>
+		std::optional<size_t> last_not_above(size_t count, arch::addr address, AddressOf&& address_of)
+		{
+			size_t low = 0;
+			size_t high = count;
+
+			while (low < high)
+			{
+				const auto middle = low + (high - low) / 2;
+
+				if (address_of(middle) <= address)
+					low = middle + 1;
+				else
+					high = middle;
+			}
+
+			if (low == 0)
+				return std::nullopt;
+
+			return low - 1;
+		}
+	}
+
+	std::string format_symbols_text(const symbol_map& symbols, arch::addr base)
+	{
+		std::string text;
+
+		for (const auto& [symbol, addr] : sorted_symbols(symbols))
+		{
+			const arch::addr addr_file = addr;
+			const arch::addr addr_mem  = addr + base;
+
+			std::format_to(std::back_inserter(text), "{:#06x} {:#06x} --> {}\n", addr_file, addr_mem, symbol);
+		}
+
+		return text;
+	}
+
+	std::vector<uint8_t> make_symbol_index(const symbol_map& symbols, std::span<const source_line> lines, arch::addr base)
+	{
+		const auto elems = sorted_symbols(symbols);
+
+		std::vector<source_line> sorted_lines(lines.begin(), lines.end());
+		std::ranges::stable_sort(sorted_lines, {}, &source_line::offset);
+
+		std::string pool;
+
+		for (const auto& [symbol, addr] : elems)
+			pool += symbol;
+
+		binary_writer writer;
+
+		writer.write_raw(std::span(reinterpret_cast<const uint8_t*>(INDEX_MAGIC.data()), INDEX_MAGIC.size()))
+			  .write(INDEX_FORMAT)
+			  .write(static_cast<uint32_t>(base))
+			  .write(static_cast<uint32_t>(elems.size()))
+			  .write(static_cast<uint32_t>(sorted_lines.size()))
+			  .write(static_cast<uint32_t>(pool.size()));
+
+		uint32_t name_offset = 0;
+
+		for (const auto& [symbol, addr] : elems)
+		{
+			writer.write(static_cast<uint32_t>(base + addr))
+				  .write(name_offset)
+				  .write(static_cast<uint32_t>(symbol.size()));
+
+			name_offset += static_cast<uint32_t>(symbol.size());
+		}
+
+		for (const auto& [offset, line] : sorted_lines)
+			writer.write(static_cast<uint32_t>(base + offset)).write(line);
+
+		writer.write_raw(std::span(reinterpret_cast<const uint8_t*>(pool.data()), pool.size()));
+
+		return writer.release();
+	}
+
+	void generate_symbols_file(const std::filesystem::path& path, const symbol_map& symbols, std::span<const source_line> lines)
+	{
+		const auto base = options::arg<arch::addr>("relocate");
+		const auto& format = options::arg<std::string>("symbols-format");
+
+		//
+		// the whole file is built in memory then written at once
+		//
+		std::vector<uint8_t> content;
+
+		if (format == "text")
+		{
+			const auto text = format_symbols_text(symbols, base);
+			content.assign(text.begin(), text.end());
+		}
+		else if (format == "binary")
+		{
+			content = make_symbol_index(symbols, lines, base);
+		}
+		else
+		{
+			throw chasm_exception("Unknown symbols format \"{}\", expected text or binary", format);
+		}
+
+		if (is_stdio(path))
+		{
+			write_stdout({ reinterpret_cast<const char*>(content.data()), content.size() });
+		}
+		else
+		{
+			std::ofstream os(path, std::ios::binary);
+
+			if (!os)
+			{
+				log::error("Could not open file \"{}\" to write symbols mapping.", path.string());
+				return;
+			}
+
+			os.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+		}
+
+		log::info("{} symbols mapping written to \"{}\".", symbols.size(), path.string());
+	}
+
+	symbol_index::symbol_index(std::span<const uint8_t> bytes_)
+		: bytes(bytes_)
+	{
+		if (bytes.size() < HEADER_SIZE || !std::ranges::equal(bytes.first(INDEX_MAGIC.size()), INDEX_MAGIC))
+			throw chasm_exception("File is not a chasm binary symbols file.");
+
+		if (const auto format = bytes[INDEX_MAGIC.size()]; format != INDEX_FORMAT)
+			throw chasm_exception("Unsupported binary symbols format {}, expected format {}.", format, INDEX_FORMAT);
+
+		symbols_count = field(8);
+		lines_count = field(12);
+
+		lines_offset = HEADER_SIZE + symbols_count * SYMBOL_ENTRY_SIZE;
+		pool_offset = lines_offset + lines_count * LINE_ENTRY_SIZE;
+
+		if (pool_offset + field(16) != bytes.size())
+			throw chasm_exception("Binary symbols file is truncated or corrupted.");
+
+		for (size_t i = 0; i < symbols_count; ++i)
+		{
+			const auto entry = HEADER_SIZE + i * SYMBOL_ENTRY_SIZE;
+
+			if (size_t { field(entry + 4) } + field(entry + 8) > field(16))
+				throw chasm_exception("Symbol {} of the binary symbols file points outside of its names.", i);
+		}
+	}
+
+	arch::addr symbol_index::base() const
+	{
+		return static_cast<arch::addr>(field(4));
+	}
+
+	size_t symbol_index::symbol_count() const
+	{
+		return symbols_count;
+	}
+
+	symbol_index::symbol symbol_index::symbol_at(size_t index) const
+	{
+		const auto entry = HEADER_SIZE + index * SYMBOL_ENTRY_SIZE;
+		const auto name = bytes.subspan(pool_offset + field(entry + 4), field(entry + 8));
+
+		return {
+			.name = std::string_view(reinterpret_cast<const char*>(name.data()), name.size()),
+			.address = static_cast<arch::addr>(field(entry))
+		};
+	}
+
+	std::optional<symbol_index::symbol> symbol_index::find(arch::addr address) const
+	{
+		const auto index = last_not_above(symbols_count, address, [this](size_t i)
+		{
+			return field(HEADER_SIZE + i * SYMBOL_ENTRY_SIZE);
+		});
+
+		if (!index)
+			return std::nullopt;
+
+		return symbol_at(*index);
+	}
+
+	std::optional<uint32_t> symbol_index::line_of(arch::addr address) const
+	{
+		const auto index = last_not_above(lines_count, address, [this](size_t i)
+		{
+			return field(lines_offset + i * LINE_ENTRY_SIZE);
+		});
+
+		if (!index)
+			return std::nullopt;
+
+		return field(lines_offset + *index * LINE_ENTRY_SIZE + 4);
+	}
+
+	uint32_t symbol_index::field(size_t offset) const
+	{
+		return bytes[offset]
+			 | bytes[offset + 1] << 8
+			 | bytes[offset + 2] << 16
+			 | static_cast<uint32_t>(bytes[offset + 3]) << 24;
+	}
+}
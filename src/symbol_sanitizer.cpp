@@ -5,12 +5,16 @@
 
 namespace chasm
 {
+	symbol_sanitizer::symbol_sanitizer(bool relocatable_)
+		: relocatable(relocatable_)
+	{}
+
 	void symbol_sanitizer::traverse(const ast::abstract_tree& ast)
 	{
 		for (const auto& branch : ast.branches())
 			branch->accept(*this);
 
-		post_visit();
+		finalize();
 	}
 
 	void symbol_sanitizer::push_scope()
@@ -149,11 +153,14 @@ namespace chasm
 		return scopes[scope].contains(symbol);
 	}
 
-	void symbol_sanitizer::post_visit()
+	void symbol_sanitizer::finalize()
 	{
 		if (!undefined_labels.empty())
 			throw sanitize_exception::undefined_symbols(undefined_labels);
 
+		if (relocatable)
+			return;
+
 		if (!undefined_procs.empty())
 			throw sanitize_exception::undefined_symbols(undefined_procs);
 
@@ -0,0 +1,235 @@
+#include <fstream>
+#include <format>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <chasm/trace.hpp>
+#include <chasm/chasm_exception.hpp>
+#include <chasm/file_io.hpp>
+#include <chasm/json.hpp>
+
+
+namespace chasm::trace
+{
+	namespace
+	{
+		using clock = std::chrono::steady_clock;
+
+		constexpr size_t BUFFER_RESERVE = 1024;
+
+		struct event
+		{
+			//
+			// 'X' for spans, 'i' for instant events, as in the trace event format
+			//
+			char phase;
+			std::string name;
+			std::string category;
+			std::string detail;
+			double timestamp_us;
+			double duration_us;
+		};
+
+		struct thread_buffer
+		{
+			uint32_t tid;
+			std::string name;
+			std::vector<event> events;
+
+			//
+			// set once the thread exits, the buffer is dropped after its events are written
+			//
+			bool finished = false;
+		};
+
+		std::atomic<bool> is_enabled = false;
+		clock::time_point epoch;
+
+		//
+		// buffers outlive their thread so the events of finished workers can still be written
+		//
+		std::mutex registry_mutex;
+		std::vector<std::unique_ptr<thread_buffer>> buffers;
+		uint32_t next_tid = 1;
+
+		struct registration
+		{
+			registration() = default;
+
+			registration(const registration&) = delete;
+			registration(registration&&) noexcept = delete;
+			registration& operator=(const registration&) = delete;
+			registration& operator=(registration&&) noexcept = delete;
+
+			~registration()
+			{
+				if (!buffer)
+					return;
+
+				std::scoped_lock lock(registry_mutex);
+				buffer->finished = true;
+			}
+
+			thread_buffer* buffer = nullptr;
+		};
+
+		thread_local registration local;
+
+		thread_buffer& buffer()
+		{
+			if (!local.buffer)
+			{
+				std::scoped_lock lock(registry_mutex);
+
+				auto& registered = buffers.emplace_back(std::make_unique<thread_buffer>());
+
+				registered->tid = next_tid++;
+				registered->events.reserve(BUFFER_RESERVE);
+
+				local.buffer = registered.get();
+			}
+
+			return *local.buffer;
+		}
+
+		double now_us()
+		{
+			return std::chrono::duration<double, std::micro>(clock::now() - epoch).count();
+		}
+	}
+
+	void enable(bool on)
+	{
+		if (on && !enabled())
+			epoch = clock::now();
+
+		is_enabled.store(on, std::memory_order_release);
+	}
+
+	bool enabled()
+	{
+		return is_enabled.load(std::memory_order_acquire);
+	}
+
+	void set_thread_name(std::string_view name)
+	{
+		if (enabled())
+			buffer().name = name;
+	}
+
+	void instant(std::string_view name, std::string_view category, std::string_view detail)
+	{
+		if (!enabled())
+			return;
+
+		buffer().events.push_back({
+			.phase = 'i',
+			.name = std::string(name),
+			.category = std::string(category),
+			.detail = std::string(detail),
+			.timestamp_us = now_us(),
+			.duration_us = 0
+		});
+	}
+
+	void write(const std::filesystem::path& path)
+	{
+		std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		std::scoped_lock lock(registry_mutex);
+
+		bool first = true;
+
+		auto separate = [&]
+		{
+			if (!first)
+				json += ",\n";
+
+			first = false;
+		};
+
+		for (const auto& thread : buffers)
+		{
+			if (!thread->name.empty())
+			{
+				separate();
+				std::format_to(std::back_inserter(json),
+							   R"({{"ph":"M","pid":1,"tid":{},"name":"thread_name","args":{{"name":"{}"}}}})",
+							   thread->tid,
+							   json::escaped(thread->name));
+			}
+
+			for (const auto& e : thread->events)
+			{
+				separate();
+				std::format_to(std::back_inserter(json),
+							   R"({{"ph":"{}","pid":1,"tid":{},"ts":{:.3f},"name":"{}","cat":"{}")",
+							   e.phase,
+							   thread->tid,
+							   e.timestamp_us,
+							   json::escaped(e.name),
+							   json::escaped(e.category));
+
+				if (e.phase == 'X')
+					std::format_to(std::back_inserter(json), R"(,"dur":{:.3f})", e.duration_us);
+				else
+					json += R"(,"s":"t")";
+
+				if (!e.detail.empty())
+					std::format_to(std::back_inserter(json), R"(,"args":{{"detail":"{}"}})", json::escaped(e.detail));
+
+				json += '}';
+			}
+		}
+
+		json += "\n]}\n";
+
+		//
+		// the events are only written once, so a --watch session keeps no more than one rebuild of them
+		//
+		for (const auto& thread : buffers)
+			thread->events.clear();
+
+		std::erase_if(buffers, [](const auto& thread) { return thread->finished; });
+
+		if (is_stdio(path))
+			return write_stdout(json);
+
+		std::ofstream os(path, std::ios::binary);
+
+		if (!os)
+			throw chasm_exception("Could not open trace file \"{}\" for writing", path.string());
+
+		os.write(json.data(), static_cast<std::streamsize>(json.size()));
+	}
+
+	scoped_span::scoped_span(std::string_view name_, std::string_view category_, std::string_view detail_)
+		: active(enabled()),
+		  name(name_),
+		  category(category_),
+		  detail(detail_)
+	{
+		if (active)
+			start_us = now_us();
+	}
+
+	scoped_span::~scoped_span()
+	{
+		if (!active)
+			return;
+
+		const auto end_us = now_us();
+
+		buffer().events.push_back({
+			.phase = 'X',
+			.name = std::string(name),
+			.category = std::string(category),
+			.detail = std::string(detail),
+			.timestamp_us = start_us,
+			.duration_us = end_us - start_us
+		});
+	}
+}
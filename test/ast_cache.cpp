@@ -0,0 +1,111 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/ast_cache.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+
+#include "options_fixture.hpp"
+#include "temp_directory.hpp"
+
+
+#define BOOST_CHECK_EQUAL_RANGES(Rng1, Rng2) BOOST_CHECK_EQUAL_COLLECTIONS(Rng1.begin(), Rng1.end(), Rng2.begin(), Rng2.end())
+
+
+namespace details
+{
+	using namespace chasm;
+
+	const std::string cached_program = "sprite s [1, 2, 3]         \n"
+									   "define N 4                 \n"
+									   "config RAW_ALIGNED = 0     \n"
+									   "proc draw_it               \n"
+									   ".again:                    \n"
+									   "    draw r0, r1, #s        \n"
+									   "    jmp [0x10]             \n"
+									   "    raw(0x00E0)            \n"
+									   "    jmp @again             \n"
+									   "endp draw_it              \n"
+									   ".main:                     \n"
+									   "    mov r0, N              \n"
+									   "    mov ar, #s             \n"
+									   "    call $draw_it          \n";
+
+	ast::abstract_tree parse_source(std::string program)
+	{
+		auto lex = lexer(std::move(program));
+		auto par = parser(lex.enumerate_tokens());
+
+		return par.make_tree();
+	}
+
+	struct temporary_file
+	{
+		test_env::temporary_directory directory { "chasm_test_ast" };
+		std::filesystem::path path = directory.path / "tree.c8a";
+	};
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(ast_cache, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(round_trip_generates_same_code)
+	{
+		const details::temporary_file file;
+		const auto key = chasm::ast_cache::make_key(details::cached_program);
+
+		chasm::ast_cache::store(file.path, key, details::parse_source(details::cached_program));
+
+		auto loaded = chasm::ast_cache::load(file.path, key);
+		BOOST_REQUIRE(loaded.has_value());
+
+		const auto expected = details::parse_source(details::cached_program).generate();
+		const auto binary = loaded->generate();
+
+		BOOST_CHECK_EQUAL_RANGES(binary, expected);
+	}
+
+	BOOST_AUTO_TEST_CASE(loaded_tokens_view_the_file)
+	{
+		std::optional<chasm::ast::abstract_tree> loaded;
+
+		{
+			const details::temporary_file file;
+			const auto key = chasm::ast_cache::make_key(details::cached_program);
+
+			chasm::ast_cache::store(file.path, key, details::parse_source(details::cached_program));
+			loaded = chasm::ast_cache::load(file.path, key);
+		}
+
+		BOOST_REQUIRE(loaded.has_value());
+
+		const auto* sprite = dynamic_cast<const chasm::ast::sprite_statement*>(loaded->branches().front().get());
+
+		BOOST_REQUIRE(sprite);
+		BOOST_CHECK(std::holds_alternative<std::string_view>(sprite->identifier.data));
+		BOOST_CHECK_EQUAL(sprite->identifier.text(), "s");
+
+		//
+		// the tree keeps the file content alive once the file is gone
+		//
+		const auto expected = details::parse_source(details::cached_program).generate();
+		const auto binary = loaded->generate();
+
+		BOOST_CHECK_EQUAL_RANGES(binary, expected);
+	}
+
+	BOOST_AUTO_TEST_CASE(stale_or_corrupted_file_is_ignored)
+	{
+		const details::temporary_file file;
+		const auto key = chasm::ast_cache::make_key(details::cached_program);
+
+		BOOST_CHECK(!chasm::ast_cache::load(file.path, key).has_value());
+
+		chasm::ast_cache::store(file.path, key, details::parse_source(details::cached_program));
+		BOOST_CHECK(!chasm::ast_cache::load(file.path, key + 1).has_value());
+
+		std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) / 2);
+		BOOST_CHECK(!chasm::ast_cache::load(file.path, key).has_value());
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#undef BOOST_CHECK_EQUAL_RANGES
@@ -0,0 +1,80 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/build_cache.hpp>
+
+#include <filesystem>
+
+#include "temp_directory.hpp"
+
+
+namespace details
+{
+	struct cache_directory : test_env::temporary_directory
+	{
+		cache_directory()
+			: temporary_directory("chasm_test_cache")
+		{}
+	};
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(build_cache, details::cache_directory)
+
+	BOOST_AUTO_TEST_CASE(miss_then_hit)
+	{
+		const auto cache = chasm::build_cache(path, 1 << 20);
+		const std::vector<uint8_t> binary = { 0x00, 0xE0, 0x12, 0x00 };
+
+		BOOST_CHECK(!cache.lookup(1, false));
+
+		cache.store(1, binary, std::nullopt);
+
+		const auto hit = cache.lookup(1, false);
+
+		BOOST_REQUIRE(hit);
+		BOOST_CHECK_EQUAL_COLLECTIONS(hit->binary.begin(), hit->binary.end(), binary.begin(), binary.end());
+		BOOST_CHECK(!hit->symbols);
+	}
+
+	BOOST_AUTO_TEST_CASE(symbols_required)
+	{
+		const auto cache = chasm::build_cache(path, 1 << 20);
+
+		cache.store(1, { 0x00, 0xEE }, std::nullopt);
+		cache.store(2, { 0x00, 0xEE }, "0x0000 0x0200 --> main\n");
+
+		BOOST_CHECK(!cache.lookup(1, true));
+
+		const auto hit = cache.lookup(2, true);
+
+		BOOST_REQUIRE(hit && hit->symbols);
+		BOOST_CHECK_EQUAL(*hit->symbols, "0x0000 0x0200 --> main\n");
+	}
+
+	BOOST_AUTO_TEST_CASE(no_temporary_left)
+	{
+		const auto cache = chasm::build_cache(path, 1 << 20);
+
+		cache.store(1, { 0x00, 0xEE }, "");
+
+		for (const auto& file : std::filesystem::directory_iterator(path))
+			BOOST_CHECK(file.path().extension() != ".tmp");
+	}
+
+	BOOST_AUTO_TEST_CASE(eviction_by_size)
+	{
+		const auto cache = chasm::build_cache(path, 16);
+		const std::vector<uint8_t> binary(10, 0xAA);
+
+		cache.store(1, binary, std::nullopt);
+		cache.store(2, binary, std::nullopt);
+
+		uintmax_t total = 0;
+
+		for (const auto& file : std::filesystem::directory_iterator(path))
+			total += file.file_size();
+
+		BOOST_CHECK_LE(total, 16);
+		BOOST_CHECK(cache.lookup(1, false).has_value() != cache.lookup(2, false).has_value());
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
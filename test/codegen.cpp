@@ -76,6 +76,9 @@ BOOST_FIXTURE_TEST_SUITE(machine_code_generation, test_env::zero_relocate)
 		BOOST_CHECK_EQUAL(details::opcode("ldfs rf"), 0xFF30);
 		BOOST_CHECK_EQUAL(details::opcode("saverpl r6"), 0xF675);
 		BOOST_CHECK_EQUAL(details::opcode("loadrpl r9"), 0xF985);
+		BOOST_CHECK_EQUAL(details::opcode("scrd 0x5"), 0x00C5);
+		BOOST_CHECK_EQUAL(details::opcode("scrr"), 0x00FB);
+		BOOST_CHECK_EQUAL(details::opcode("scrl"), 0x00FC);
 
 		BOOST_CHECK_EQUAL(details::opcode("jmp [0xFFF]"), 0xBFFF);
 	}
@@ -299,4 +302,41 @@ BOOST_AUTO_TEST_SUITE(sprite_padding)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+
+BOOST_AUTO_TEST_SUITE(deterministic_layout)
+
+	//
+	// std::hash cannot be reseeded, declaring the sprites in an order unrelated to their names
+	// catches any layout following the order of a hash map instead of the declarations
+	//
+	BOOST_FIXTURE_TEST_CASE(sprites_in_declaration_order, test_env::default_options)
+	{
+		constexpr int SPRITE_COUNT = 40;
+
+		std::string program;
+		std::vector<uint8_t> expected_code;
+
+		for (int i = 0; i < SPRITE_COUNT; ++i)
+		{
+			const int row = (i * 7) % SPRITE_COUNT;
+
+			program += std::format("sprite s{} [{}]\n", row, row);
+			expected_code.push_back(static_cast<uint8_t>(row));
+		}
+
+		program += ".main:\n";
+
+		const auto first = details::try_codegen(std::string(program));
+
+		BOOST_CHECK_EQUAL_RANGES(first, expected_code);
+
+		for (int run = 0; run < 4; ++run)
+		{
+			const auto again = details::try_codegen(std::string(program));
+			BOOST_CHECK_EQUAL_RANGES(again, first);
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 #undef BOOST_CHECK_EQUAL_RANGES
@@ -0,0 +1,172 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+#include <chasm/options.hpp>
+#include <chasm/ds/source_listing.hpp>
+#include <chasm/ds/batch.hpp>
+
+#include <fstream>
+#include <sstream>
+
+#include "options_fixture.hpp"
+#include "temp_directory.hpp"
+
+
+namespace details
+{
+	using namespace chasm;
+
+	std::vector<uint8_t> assemble_rom(std::string source)
+	{
+		auto lex = lexer(std::move(source));
+		auto par = parser(lex.enumerate_tokens());
+		auto ast = par.make_tree();
+
+		return ast.generate();
+	}
+
+	std::string rom_source(const std::vector<uint8_t>& rom)
+	{
+		const auto base = options::arg<arch::addr>("relocate");
+
+		return ds::render_source(rom, base, ds::disassembler(rom, base).get_graph());
+	}
+
+	struct batch_directory
+	{
+		batch_directory()
+		{
+			std::filesystem::create_directories(root / "roms" / "nested");
+		}
+
+		void write(const std::string& file, const std::vector<uint8_t>& content) const
+		{
+			std::ofstream(root / file, std::ios::binary).write(reinterpret_cast<const char*>(content.data()),
+															   static_cast<std::streamsize>(content.size()));
+		}
+
+		test_env::temporary_directory directory { "chasm_test_batch" };
+		std::filesystem::path root = directory.path;
+	};
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(batch_disassembly, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(test_source_reassembles_to_rom)
+	{
+		const auto rom = details::assemble_rom("sprite box [0xFF, 0x81, 0xFF]\n"
+											   "proc draw_box\n"
+											   "    mov ar, #box\n"
+											   "    draw r0, r1, 3\n"
+											   "    ret\n"
+											   "endp draw_box\n"
+											   ".main:\n"
+											   "    mov r0, 0\n"
+											   ".loop:\n"
+											   "    call $draw_box\n"
+											   "    add r0, 4\n"
+											   "    se r0, 0x20\n"
+											   "    jmp @loop\n"
+											   "    jmp [0x10]\n");
+
+		const auto source = details::rom_source(rom);
+
+		BOOST_CHECK(source.find("jmp @loc_") != std::string::npos);
+		BOOST_CHECK(details::assemble_rom(source) == rom);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_glob_matches)
+	{
+		BOOST_CHECK(chasm::ds::glob_matches("*.ch8", "pong.ch8"));
+		BOOST_CHECK(chasm::ds::glob_matches("p?ng*", "pong.ch8"));
+		BOOST_CHECK(chasm::ds::glob_matches("*o*g*", "pong.ch8"));
+		BOOST_CHECK(!chasm::ds::glob_matches("*.ch8", "pong.c8c"));
+		BOOST_CHECK(!chasm::ds::glob_matches("?ong", "pong.ch8"));
+	}
+
+	BOOST_AUTO_TEST_CASE(test_batch_collects_failures)
+	{
+		const details::batch_directory dir;
+
+		dir.write("roms/good.ch8", details::assemble_rom(".main:\n cls\n jmp @main\n"));
+		dir.write("roms/nested/bad.ch8", { 0xFF, 0xFF, 0xFF, 0xFF });
+		dir.write("roms/notes.txt", { 'h', 'i' });
+
+		const std::vector<std::string> arguments { (dir.root / "roms").string() };
+		const auto inputs = chasm::ds::expand_batch(arguments);
+
+		BOOST_REQUIRE_EQUAL(inputs.size(), 2);
+
+		const auto batch = chasm::ds::disassembly_batch(chasm::options::arg<chasm::arch::addr>("relocate"),
+														chasm::ds::disassembly_mode::recursive,
+														dir.root / "out");
+		const auto results = batch.run(inputs, 2);
+
+		BOOST_REQUIRE_EQUAL(results.size(), 2);
+
+		const auto& good = results[0].rom.filename() == "good.ch8" ? results[0] : results[1];
+		const auto& bad = results[0].rom.filename() == "good.ch8" ? results[1] : results[0];
+
+		BOOST_CHECK(!good.error);
+		BOOST_CHECK(std::filesystem::exists(dir.root / "out" / "good.c8"));
+		BOOST_REQUIRE(bad.error);
+		BOOST_CHECK(!std::filesystem::exists(dir.root / "out" / "nested" / "bad.c8"));
+
+		std::ostringstream report;
+		chasm::ds::disassembly_batch::write_report(report, results);
+
+		BOOST_CHECK(report.str().find("failed\t" + bad.rom.string() + "\t" + *bad.error) != std::string::npos);
+		BOOST_CHECK(report.str().find("ok\t" + good.rom.string()) != std::string::npos);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_batch_listing_collisions)
+	{
+		const details::batch_directory dir;
+		const auto rom = details::assemble_rom(".main:\n cls\n jmp @main\n");
+
+		dir.write("roms/x.ch8", rom);
+		dir.write("roms/nested/x.ch8", rom);
+		dir.write("roms/nested/y.ch8", rom);
+
+		//
+		// the file given and the directory both hold an x.ch8, so both listings would be out/x.c8
+		//
+		const std::vector<std::string> arguments { (dir.root / "roms" / "x.ch8").string(), (dir.root / "roms" / "nested").string() };
+		const auto inputs = chasm::ds::expand_batch(arguments);
+
+		BOOST_REQUIRE_EQUAL(inputs.size(), 3);
+
+		const auto batch = chasm::ds::disassembly_batch(chasm::options::arg<chasm::arch::addr>("relocate"),
+														chasm::ds::disassembly_mode::recursive,
+														dir.root / "out");
+
+		for (const auto& result : batch.run(inputs, 2))
+		{
+			if (result.rom.filename() == "y.ch8")
+				BOOST_CHECK(!result.error);
+			else
+				BOOST_CHECK(result.error && result.error->contains("would also be written"));
+		}
+
+		BOOST_CHECK(!std::filesystem::exists(dir.root / "out" / "x.c8"));
+	}
+
+	BOOST_AUTO_TEST_CASE(test_expand_patterns)
+	{
+		const details::batch_directory dir;
+
+		dir.write("roms/a.ch8", { 0x00, 0xE0 });
+		dir.write("roms/b.ch8", { 0x00, 0xE0 });
+		dir.write("roms/c.sc8", { 0x00, 0xE0 });
+
+		const std::vector<std::string> pattern { (dir.root / "roms" / "*.ch8").string(), (dir.root / "roms" / "a.ch8").string() };
+
+		BOOST_CHECK_EQUAL(chasm::ds::expand_batch(pattern).size(), 2);
+
+		const std::vector<std::string> unmatched { (dir.root / "roms" / "*.xo8").string() };
+
+		BOOST_CHECK_THROW((void) chasm::ds::expand_batch(unmatched), chasm::chasm_exception);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
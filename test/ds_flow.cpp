@@ -1,7 +1,11 @@
 #include <boost/test/unit_test.hpp>
 #include <chasm/lexer.hpp>
 #include <chasm/parser.hpp>
+#include <chasm/options.hpp>
+#include <chasm/ds/control_flow_graph.hpp>
 #include <chasm/ds/disassembler.hpp>
+#include <chasm/ds/linear_sweep.hpp>
+#include <chasm/ds/listing_renderer.hpp>
 
 #include "options_fixture.hpp"
 
@@ -20,11 +24,71 @@ namespace details
 		return ast.generate();
 	}
 
+	//
+	// The options are only parsed once per test run, so the load address may not be the fixture's
+	//
+	arch::addr load_address()
+	{
+		return options::arg<arch::addr>("relocate");
+	}
+
+	ds::disassembly_graph
+	make_graph(std::string&& source)
+	{
+		return ds::disassembler(codegen(std::move(source)), load_address()).get_graph();
+	}
+
 	std::vector<ds::path>
 	make_paths(std::string&& source)
 	{
-		auto ds = ds::disassembler(codegen(std::move(source)));
-		return ds.code_paths();
+		const auto graph = make_graph(std::move(source));
+		const auto paths = graph.get_paths();
+
+		return { paths.begin(), paths.end() };
+	}
+
+	//
+	// Every procedure and path of the graph with their instructions, to compare whole graphs
+	//
+	std::string
+	graph_listing(const ds::disassembly_graph& graph)
+	{
+		std::string listing;
+
+		const auto list_path = [&](const ds::path& path)
+		{
+			listing += std::format(".loc_{:04X}:\n", path.addr_start());
+
+			for (size_t i = 0; i < path.instructions_count(); ++i)
+				listing += path.symbolic(i) + '\n';
+		};
+
+		for (const auto& proc : graph.get_procedures())
+		{
+			listing += std::format("proc {:04X}\n", proc.entrypoint());
+
+			for (const auto& path : proc.get_paths())
+				list_path(path);
+		}
+
+		for (const auto& path : graph.get_paths())
+			list_path(path);
+
+		return listing;
+	}
+
+	ds::control_flow_graph
+	make_cfg(const std::vector<uint8_t>& rom)
+	{
+		const arch::addr entry = load_address();
+
+		return ds::control_flow_graph(ds::predecode(rom), entry, std::span(&entry, 1));
+	}
+
+	std::string
+	threaded_listing(const std::vector<uint8_t>& rom, unsigned int threads)
+	{
+		return graph_listing(ds::disassembler(rom, load_address(), ds::disassembly_mode::recursive, threads).get_graph());
 	}
 }
 
@@ -45,12 +109,14 @@ BOOST_FIXTURE_TEST_SUITE(paths_checker, test_env::zero_relocate)
 				".L4:          \n"
 				"	exit       \n");
 
-		BOOST_CHECK_EQUAL(paths.size(), 5);
-		BOOST_CHECK_EQUAL(paths[0].addr_start(), 0);
-		BOOST_CHECK_EQUAL(paths[1].addr_start(), 2);
-		BOOST_CHECK_EQUAL(paths[2].addr_start(), 4);
-		BOOST_CHECK_EQUAL(paths[3].addr_start(), 6);
-		BOOST_CHECK_EQUAL(paths[4].addr_start(), 8);
+		const auto base = details::load_address();
+
+		BOOST_REQUIRE_EQUAL(paths.size(), 5);
+		BOOST_CHECK_EQUAL(paths[0].addr_start(), base + 0);
+		BOOST_CHECK_EQUAL(paths[1].addr_start(), base + 2);
+		BOOST_CHECK_EQUAL(paths[2].addr_start(), base + 4);
+		BOOST_CHECK_EQUAL(paths[3].addr_start(), base + 6);
+		BOOST_CHECK_EQUAL(paths[4].addr_start(), base + 8);
 	}
 
 	BOOST_AUTO_TEST_CASE(test_no_loop)
@@ -76,5 +142,560 @@ BOOST_FIXTURE_TEST_SUITE(paths_checker, test_env::zero_relocate)
 		BOOST_CHECK_EQUAL(paths.size(), 1);
 	}
 
+	BOOST_AUTO_TEST_CASE(test_misaligned_jump_target)
+	{
+		const auto base = details::load_address();
+		const auto target = static_cast<uint16_t>(base + 5);
+
+		//
+		// the jump lands in the middle of the path it belongs to, so the bytes are decoded again from there
+		//
+		const std::vector<uint8_t> rom = {
+			0x00, 0xE0,
+			static_cast<uint8_t>(0x10 | target >> 8), static_cast<uint8_t>(target & 0xFF),
+			0x00,
+			0x00, 0xFD
+		};
+
+		const auto graph = chasm::ds::disassembler(rom, base).get_graph();
+		const auto paths = graph.get_paths();
+
+		BOOST_REQUIRE_EQUAL(paths.size(), 2);
+		BOOST_CHECK_EQUAL(paths.rbegin()->addr_start(), target);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_skip_follows_both_outcomes)
+	{
+		const auto paths = details::make_paths(
+				".main:        \n"
+				"	se r0, 1   \n"
+				"	jmp @main  \n"
+				"	exit       \n");
+
+		const auto base = details::load_address();
+
+		//
+		// the main path, then the jump and the skipped over exit
+		//
+		BOOST_REQUIRE_EQUAL(paths.size(), 3);
+		BOOST_CHECK_EQUAL(paths[0].addr_start(), base + 0);
+		BOOST_CHECK_EQUAL(paths[1].addr_start(), base + 2);
+		BOOST_CHECK_EQUAL(paths[2].addr_start(), base + 4);
+		BOOST_CHECK(paths[1].symbolic(0).starts_with("jmp"));
+		BOOST_CHECK(paths[2].symbolic(0).starts_with("exit"));
+	}
+
+	BOOST_AUTO_TEST_CASE(test_instructions_rendered_from_opcode)
+	{
+		const auto paths = details::make_paths(
+				".main:              \n"
+				"	draw r1, r2, 5   \n"
+				"	add r3, 1        \n"
+				"	exit             \n");
+
+		BOOST_REQUIRE_EQUAL(paths.size(), 1);
+		BOOST_REQUIRE_EQUAL(paths[0].instructions_count(), 3);
+		BOOST_CHECK_EQUAL(paths[0].instruction(0).opcode, 0xD125);
+		BOOST_CHECK_EQUAL(paths[0].symbolic(0), "draw r1, r2, 0x5");
+		BOOST_CHECK_EQUAL(paths[0].symbolic(1), "inc r3");
+		BOOST_CHECK_EQUAL(paths[0].symbolic(2), "exit ");
+	}
+
+	BOOST_AUTO_TEST_CASE(test_decodes_what_is_encoded)
+	{
+		const auto paths = details::make_paths(
+				".main:              \n"
+				"	shr r1, r2       \n"
+				"	shl r1, r2       \n"
+				"	bcd r3           \n"
+				"	wkey r4          \n"
+				"	scrd 3           \n"
+				"	exit             \n");
+
+		BOOST_REQUIRE_EQUAL(paths.size(), 1);
+		BOOST_REQUIRE_EQUAL(paths[0].instructions_count(), 6);
+		BOOST_CHECK_EQUAL(paths[0].symbolic(0), "shr r1, r2");
+		BOOST_CHECK_EQUAL(paths[0].symbolic(1), "shl r1, r2");
+		BOOST_CHECK_EQUAL(paths[0].symbolic(2), "bcd r3");
+		BOOST_CHECK_EQUAL(paths[0].symbolic(3), "wkey r4");
+		BOOST_CHECK_EQUAL(paths[0].symbolic(4), "scrd 0x3");
+	}
+
+	BOOST_AUTO_TEST_CASE(test_invalid_opcodes)
+	{
+		const auto base = details::load_address();
+
+		//
+		// 9XYN and EXNN only decode for N = 0 and NN = 9E or A1
+		//
+		for (const auto opcode : { 0x9121, 0xE107, 0xE133, 0x01C3 })
+		{
+			const std::vector<uint8_t> rom = { static_cast<uint8_t>(opcode >> 8), static_cast<uint8_t>(opcode & 0xFF) };
+			BOOST_CHECK_THROW(chasm::ds::disassembler(rom, base), chasm::ds::disassembly_exception::decoding_error);
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE(test_long_jump_chain)
+	{
+		constexpr size_t CHAIN = 1500;
+
+		std::string source = ".main:\n";
+
+		for (size_t i = 0; i < CHAIN; ++i)
+			source += std::format("\tjmp @L{0}\n.L{0}:\n", i);
+
+		source += "\texit\n";
+
+		const auto paths = details::make_paths(std::move(source));
+
+		BOOST_REQUIRE_EQUAL(paths.size(), CHAIN + 1);
+		BOOST_CHECK_EQUAL(paths.back().addr_start(), details::load_address() + CHAIN * 2);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_long_call_chain)
+	{
+		constexpr size_t CHAIN = 700;
+
+		std::string source;
+
+		for (size_t i = 0; i < CHAIN; ++i)
+			source += std::format("proc p{0}\n\tcall $p{1}\n\tret\nendp p{0}\n", i, i + 1);
+
+		source += std::format("proc p{0}\n\tret\nendp p{0}\n.main:\n\tcall $p0\n\texit\n", CHAIN);
+
+		const auto graph = details::make_graph(std::move(source));
+
+		BOOST_CHECK_EQUAL(graph.get_procedures().size(), CHAIN + 1);
+		BOOST_CHECK_EQUAL(graph.get_paths().size(), 1);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_graph_lookups)
+	{
+		const auto graph = details::make_graph(
+				"proc p        \n"
+				"	se r0, 1   \n"
+				"	ret        \n"
+				"	ret        \n"
+				"endp p        \n"
+				".main:        \n"
+				"	call $p    \n"
+				"	jmp @main  \n");
+
+		const auto base = details::load_address();
+		const auto* const proc = graph.find_procedure(static_cast<chasm::arch::addr>(base + 4));
+
+		BOOST_REQUIRE(proc != nullptr);
+		BOOST_CHECK_EQUAL(proc, &graph.get_procedures()[0]);
+		BOOST_REQUIRE(proc->find_path(static_cast<chasm::arch::addr>(base + 8)) != nullptr);
+		BOOST_CHECK_EQUAL(proc->find_path(static_cast<chasm::arch::addr>(base + 8))->instructions_count(), 1);
+		BOOST_CHECK(proc->find_path(static_cast<chasm::arch::addr>(base + 7)) == nullptr);
+		BOOST_CHECK(graph.find_procedure(base) == nullptr);
+		BOOST_CHECK_EQUAL(graph.find_path(base), &graph.get_paths()[0]);
+
+		//
+		// the views are sorted by address
+		//
+		BOOST_CHECK(std::ranges::is_sorted(proc->get_paths(), {}, &chasm::ds::path::addr_start));
+	}
+
+	BOOST_AUTO_TEST_CASE(test_graph_finalize)
+	{
+		chasm::ds::path first_at_6(6);
+		first_at_6.add_instruction(chasm::arch::instruction_id::CLS, chasm::arch::operands_mask::MASK_NONE, 0x00E0);
+
+		chasm::ds::disassembly_graph graph;
+
+		graph.append_path(std::move(first_at_6));
+		graph.append_path(chasm::ds::path(2));
+		graph.append_path(chasm::ds::path(6));
+		graph.finalize();
+
+		//
+		// sorted once built, the first path appended at an address is kept
+		//
+		BOOST_REQUIRE_EQUAL(graph.get_paths().size(), 2);
+		BOOST_CHECK_EQUAL(graph.get_paths()[0].addr_start(), 2);
+		BOOST_CHECK_EQUAL(graph.get_paths()[1].instructions_count(), 1);
+
+		graph.insert_path(chasm::ds::path(4));
+		graph.insert_path(chasm::ds::path(2));
+
+		BOOST_REQUIRE_EQUAL(graph.get_paths().size(), 3);
+		BOOST_CHECK_EQUAL(graph.find_path(4), &graph.get_paths()[1]);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_listing_rendered)
+	{
+		const auto graph = details::make_graph(
+				"proc p        \n"
+				"	ret        \n"
+				"endp p        \n"
+				".main:        \n"
+				"	cls        \n"
+				"	call $p    \n"
+				"	exit       \n");
+
+		const auto base = details::load_address();
+		const auto proc = static_cast<chasm::arch::addr>(base + 6);
+		const auto call = chasm::ds::formatter::format(chasm::arch::CALL, chasm::arch::MASK_ADDR, chasm::arch::enc::_2NNN(proc));
+
+		BOOST_CHECK_EQUAL(chasm::ds::render_listing(graph),
+						  std::format("proc sub_{0:04X}\n"
+									  "    ret \n"
+									  "endp sub_{0:04X}\n"
+									  "\n"
+									  ".loc_{1:04X}:\n"
+									  "    cls \n"
+									  "    {2}\n"
+									  "    exit \n", proc, base, call));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_FIXTURE_TEST_SUITE(disassembly_modes, test_env::zero_relocate)
+
+	BOOST_AUTO_TEST_CASE(test_linear_sweep_runs)
+	{
+		//
+		// jmp, data, cls, exit, mov running into data
+		//
+		const std::vector<uint8_t> rom = {
+			0x12, 0x00,
+			0x00, 0x00,
+			0x00, 0xE0,
+			0x00, 0xFD,
+			0x60, 0x01,
+			0x00, 0x00
+		};
+
+		const auto runs = chasm::ds::linear_sweep(chasm::ds::predecode(rom));
+
+		BOOST_REQUIRE_EQUAL(runs.size(), 3);
+		BOOST_CHECK_EQUAL(runs[0].offset, 0);
+		BOOST_CHECK_EQUAL(runs[0].instructions, 1);
+		BOOST_CHECK(runs[0].terminated);
+		BOOST_CHECK_EQUAL(runs[1].offset, 4);
+		BOOST_CHECK_EQUAL(runs[1].instructions, 2);
+		BOOST_CHECK(runs[1].terminated);
+		BOOST_CHECK_EQUAL(runs[2].offset, 8);
+		BOOST_CHECK_EQUAL(runs[2].instructions, 1);
+		BOOST_CHECK(!runs[2].terminated);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_linear_sweep_across_blocks)
+	{
+		//
+		// a run of 100 instructions spans two blocks of 64 words
+		//
+		std::vector<uint8_t> rom;
+
+		for (size_t i = 0; i < 100; ++i)
+			rom.insert(rom.end(), { 0x60, 0x01 });
+
+		rom.insert(rom.end(), { 0x00, 0xEE });
+
+		const auto runs = chasm::ds::linear_sweep(chasm::ds::predecode(rom));
+
+		BOOST_REQUIRE_EQUAL(runs.size(), 1);
+		BOOST_CHECK_EQUAL(runs[0].instructions, 101);
+		BOOST_CHECK(runs[0].terminated);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_hybrid_finds_indirect_targets)
+	{
+		const auto base = details::load_address();
+		const auto target = static_cast<uint16_t>(base + 4);
+
+		//
+		// only reached through the indirect jump, then data the linear mode shows as code
+		//
+		const std::vector<uint8_t> rom = {
+			static_cast<uint8_t>(0xB0 | target >> 8), static_cast<uint8_t>(target & 0xFF),
+			0x00, 0x00,
+			0x00, 0xE0,
+			0x00, 0xFD,
+			0x60, 0x01,
+			0x00, 0x00
+		};
+
+		using chasm::ds::disassembly_mode;
+
+		const auto recursive = chasm::ds::disassembler(rom, base, disassembly_mode::recursive).get_graph();
+		const auto linear = chasm::ds::disassembler(rom, base, disassembly_mode::linear).get_graph();
+		const auto hybrid = chasm::ds::disassembler(rom, base, disassembly_mode::hybrid).get_graph();
+
+		BOOST_CHECK_EQUAL(recursive.get_paths().size(), 1);
+		BOOST_CHECK_EQUAL(linear.get_paths().size(), 3);
+
+		const auto paths = hybrid.get_paths();
+
+		BOOST_REQUIRE_EQUAL(paths.size(), 2);
+		BOOST_CHECK_EQUAL(paths.rbegin()->addr_start(), target);
+		BOOST_CHECK_EQUAL(paths.rbegin()->instructions_count(), 2);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_hybrid_stops_at_decoded_code)
+	{
+		const auto base = details::load_address();
+		const auto target = static_cast<uint16_t>(base + 6);
+
+		const std::vector<uint8_t> rom = {
+			static_cast<uint8_t>(0x10 | target >> 8), static_cast<uint8_t>(target & 0xFF),
+			0x00, 0x00,
+			0x00, 0xE0,
+			0x00, 0xE0,
+			0x00, 0xFD
+		};
+
+		const auto graph = chasm::ds::disassembler(rom, base, chasm::ds::disassembly_mode::hybrid).get_graph();
+		const auto paths = graph.get_paths();
+
+		//
+		// the cls only found by the linear sweep falls into the path the jump already decoded
+		//
+		BOOST_REQUIRE_EQUAL(paths.size(), 3);
+		BOOST_CHECK_EQUAL(paths[1].addr_start(), base + 4);
+		BOOST_CHECK_EQUAL(paths[1].instructions_count(), 1);
+		BOOST_CHECK_EQUAL(paths[2].addr_start(), target);
+		BOOST_CHECK_EQUAL(paths[2].instructions_count(), 2);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_parse_disassembly_mode)
+	{
+		BOOST_CHECK(chasm::ds::parse_disassembly_mode("hybrid") == chasm::ds::disassembly_mode::hybrid);
+		BOOST_CHECK(!chasm::ds::parse_disassembly_mode("sweep"));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_FIXTURE_TEST_SUITE(parallel_analysis, test_env::zero_relocate)
+
+	BOOST_AUTO_TEST_CASE(test_parallel_matches_serial)
+	{
+		std::string source;
+
+		//
+		// procedures calling each other back and forth, with their own loops and skips
+		//
+		for (size_t i = 0; i < 64; ++i)
+		{
+			source += std::format("proc p{0}\n.loop:\n\tse r{1:x}, 1\n\tjmp @loop\n", i, i % 16);
+
+			if (i > 0)
+				source += std::format("\tcall $p{}\n", i / 2);
+
+			source += std::format("\tret\nendp p{}\n", i);
+		}
+
+		source += ".main:\n";
+
+		for (size_t i = 0; i < 64; i += 7)
+			source += std::format("\tcall $p{}\n", i);
+
+		source += ".end:\n\tjmp @end\n";
+
+		const auto rom = details::codegen(std::move(source));
+		const auto serial = details::threaded_listing(rom, 1);
+
+		BOOST_CHECK_EQUAL(details::threaded_listing(rom, 4), serial);
+		BOOST_CHECK_EQUAL(details::threaded_listing(rom, 0), serial);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_parallel_shared_label)
+	{
+		const auto base = details::load_address();
+
+		const auto opcode = [](uint16_t op) -> std::array<uint8_t, 2>
+		{
+			return { static_cast<uint8_t>(op >> 8), static_cast<uint8_t>(op & 0xFF) };
+		};
+
+		//
+		// the second procedure jumps to a label of the first one, which the serial traversal
+		// decoded already and leaves out of the second procedure
+		//
+		std::vector<uint8_t> rom;
+
+		for (const auto op : { 0x2000 | (base + 6), 0x2000 | (base + 18), 0x1000 | (base + 4),
+							   0x3001, 0x1000 | (base + 12), 0x00EE,
+							   0x00E0, 0x00EE, 0x00E0,
+							   0x1000 | (base + 12) })
+		{
+			const auto bytes = opcode(static_cast<uint16_t>(op));
+			rom.insert(rom.end(), bytes.begin(), bytes.end());
+		}
+
+		const auto graph = chasm::ds::disassembler(rom, base).get_graph();
+
+		BOOST_REQUIRE_EQUAL(graph.get_procedures().size(), 2);
+		BOOST_CHECK_EQUAL(graph.get_procedures().rbegin()->get_paths().size(), 1);
+		BOOST_CHECK_EQUAL(details::threaded_listing(rom, 4), details::threaded_listing(rom, 1));
+	}
+
+	BOOST_AUTO_TEST_CASE(test_parallel_decoding_error)
+	{
+		const auto base = details::load_address();
+		const auto callee = static_cast<uint16_t>(base + 4);
+
+		//
+		// the called procedure runs into an opcode that does not decode
+		//
+		const std::vector<uint8_t> rom = {
+			static_cast<uint8_t>(0x20 | callee >> 8), static_cast<uint8_t>(callee & 0xFF),
+			0x00, 0xFD,
+			0x00, 0xE0,
+			0x91, 0x21
+		};
+
+		BOOST_CHECK_THROW(chasm::ds::disassembler(rom, base, chasm::ds::disassembly_mode::recursive, 4),
+						  chasm::ds::disassembly_exception::decoding_error);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_FIXTURE_TEST_SUITE(control_flow, test_env::zero_relocate)
+
+	BOOST_AUTO_TEST_CASE(test_skip_successors)
+	{
+		const auto cfg = details::make_cfg(details::codegen(
+				".main:        \n"
+				"	sne r0, 1  \n"
+				"	mov r1, 2  \n"
+				"	cls        \n"
+				".end:         \n"
+				"	jmp @end   \n"));
+
+		const auto base = details::load_address();
+		const auto blocks = cfg.blocks();
+
+		//
+		// the jump lands after cls, which splits it from its block
+		//
+		BOOST_REQUIRE_EQUAL(blocks.size(), 4);
+		BOOST_CHECK_EQUAL(blocks[2].start, base + 4);
+		BOOST_CHECK_EQUAL(blocks[2].end, base + 6);
+		BOOST_CHECK_EQUAL(*cfg.block_containing(static_cast<chasm::arch::addr>(base + 7)), 3);
+		BOOST_CHECK(!cfg.block_at(static_cast<chasm::arch::addr>(base + 8)));
+
+		BOOST_REQUIRE_EQUAL(blocks[0].successors.size(), 2);
+		BOOST_CHECK_EQUAL(blocks[0].successors[0], 1);
+		BOOST_CHECK_EQUAL(blocks[0].successors[1], 2);
+		BOOST_CHECK_EQUAL(blocks[2].predecessors.size(), 2);
+
+		BOOST_CHECK(!cfg.immediate_dominator(0));
+		BOOST_CHECK_EQUAL(*cfg.immediate_dominator(1), 0);
+		BOOST_CHECK_EQUAL(*cfg.immediate_dominator(2), 0);
+		BOOST_CHECK_EQUAL(*cfg.immediate_dominator(3), 2);
+		BOOST_CHECK(cfg.dominates(0, 3));
+		BOOST_CHECK(!cfg.dominates(1, 2));
+
+		BOOST_CHECK(cfg.is_loop_header(3));
+		BOOST_CHECK_EQUAL(cfg.loop_depth(3), 1);
+		BOOST_CHECK_EQUAL(cfg.loop_depth(2), 0);
+	}
+
+	BOOST_AUTO_TEST_CASE(test_natural_loop)
+	{
+		const auto cfg = details::make_cfg(details::codegen(
+				".main:         \n"
+				"	mov r0, 0   \n"
+				".loop:         \n"
+				"	add r0, 1   \n"
+				"	se r0, 10   \n"
+				"	jmp @loop   \n"
+				"	cls         \n"
+				".end:          \n"
+				"	jmp @end    \n"));
+
+		const auto blocks = cfg.blocks();
+
+		BOOST_REQUIRE_EQUAL(blocks.size(), 5);
+		BOOST_REQUIRE_EQUAL(cfg.loops().size(), 2);
+
+		const auto& loop = cfg.loops()[0];
+
+		BOOST_CHECK_EQUAL(loop.header, 1);
+		BOOST_CHECK(loop.blocks == std::vector<chasm::ds::control_flow_graph::block_index>({ 1, 2 }));
+
+		BOOST_CHECK_EQUAL(cfg.loop_depth(0), 0);
+		BOOST_CHECK_EQUAL(cfg.loop_depth(2), 1);
+		BOOST_CHECK_EQUAL(cfg.loop_depth(3), 0);
+		BOOST_CHECK_EQUAL(*cfg.immediate_dominator(3), 1);
+		BOOST_CHECK(cfg.dominates(1, 4));
+	}
+
+	BOOST_AUTO_TEST_CASE(test_several_roots)
+	{
+		const auto rom = details::codegen(
+				".main:          \n"
+				"	cls          \n"
+				"	jmp @join    \n"
+				".other:         \n"
+				"	cls          \n"
+				".join:          \n"
+				"	jmp @join    \n");
+
+		const auto base = details::load_address();
+		const std::vector<chasm::arch::addr> roots { base, static_cast<chasm::arch::addr>(base + 4) };
+		const auto cfg = chasm::ds::control_flow_graph(chasm::ds::predecode(rom), base, roots);
+
+		BOOST_REQUIRE_EQUAL(cfg.blocks().size(), 3);
+		BOOST_REQUIRE_EQUAL(cfg.roots().size(), 2);
+
+		//
+		// reached from both roots, the join is only dominated by the virtual block preceding them
+		//
+		BOOST_CHECK(!cfg.immediate_dominator(0));
+		BOOST_CHECK(!cfg.immediate_dominator(1));
+		BOOST_CHECK(!cfg.immediate_dominator(2));
+		BOOST_CHECK(!cfg.dominates(0, 2));
+		BOOST_CHECK(cfg.is_loop_header(2));
+	}
+
+	BOOST_AUTO_TEST_CASE(test_program_flow)
+	{
+		const auto rom = details::codegen(
+				"proc count      \n"
+				"	add r0, 1    \n"
+				"	skne r0      \n"
+				"	mov r0, 0    \n"
+				"	ret          \n"
+				"endp count      \n"
+				".main:          \n"
+				"	call $count  \n"
+				"	jmp @main    \n");
+
+		const auto base = details::load_address();
+		const chasm::ds::disassembler disassembler(rom, base);
+		const auto& graph = disassembler.get_graph();
+		const auto flow = chasm::ds::build_program_flow(disassembler.get_opcodes(), base, base, graph);
+
+		BOOST_REQUIRE_EQUAL(flow.procedures.size(), 1);
+		BOOST_CHECK_EQUAL(flow.entry.blocks().size(), 1);
+		BOOST_CHECK(flow.entry.is_loop_header(0));
+
+		const auto& proc = flow.procedures[0];
+
+		BOOST_REQUIRE_EQUAL(proc.blocks().size(), 3);
+		BOOST_CHECK_EQUAL(proc.blocks()[0].start, graph.get_procedures()[0].entrypoint());
+		BOOST_CHECK_EQUAL(proc.blocks()[0].successors.size(), 2);
+		BOOST_CHECK(proc.loops().empty());
+
+		const auto dot = chasm::ds::export_dot(flow);
+
+		BOOST_CHECK(dot.find("label=\"main\"") != std::string::npos);
+		BOOST_CHECK(dot.find(std::format("label=\"sub_{:04X}\"", proc.blocks()[0].start)) != std::string::npos);
+		BOOST_CHECK(dot.find("f0_0 -> f0_0;") != std::string::npos);
+		BOOST_CHECK(dot.find("peripheries=2") != std::string::npos);
+
+		const auto listing = chasm::ds::render_listing(graph, &flow);
+
+		BOOST_CHECK(listing.find(std::format(";; block 0x{0:04X}, from 0x{1:04X} 0x{2:04X}, idom 0x{1:04X}",
+											 proc.blocks()[2].start, proc.blocks()[0].start, proc.blocks()[1].start)) != std::string::npos);
+		BOOST_CHECK(chasm::ds::render_listing(graph).find(";; block") == std::string::npos);
+	}
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_SUITE_END()
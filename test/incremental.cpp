@@ -0,0 +1,153 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/incremental.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+
+#include <sstream>
+
+#include "options_fixture.hpp"
+
+
+#define BOOST_CHECK_EQUAL_RANGES(Rng1, Rng2) BOOST_CHECK_EQUAL_COLLECTIONS(Rng1.begin(), Rng1.end(), Rng2.begin(), Rng2.end())
+
+
+namespace details
+{
+	using namespace chasm;
+
+	ast::abstract_tree make_tree(std::string program)
+	{
+		auto lex = lexer(std::move(program));
+		auto par = parser(lex.enumerate_tokens());
+
+		return par.make_tree();
+	}
+
+	std::vector<uint8_t> codegen(std::string program)
+	{
+		return make_tree(std::move(program)).generate();
+	}
+
+	std::vector<uint8_t> codegen(std::string program, incremental_state& state)
+	{
+		return make_tree(std::move(program)).generate(state);
+	}
+
+	//
+	// Messages logged while generating the program
+	//
+	std::string generation_log(std::string program, incremental_state& state)
+	{
+		std::ostringstream captured;
+		auto* const previous = std::cout.rdbuf(captured.rdbuf());
+
+		try
+		{
+			(void) codegen(std::move(program), state);
+		}
+		catch (...)
+		{
+			std::cout.rdbuf(previous);
+			throw;
+		}
+
+		std::cout.rdbuf(previous);
+
+		return captured.str();
+	}
+
+	std::string program(std::string_view first_proc_body)
+	{
+		return std::format("sprite s [1, 2, 3]             \n"
+						   "define N 4                     \n"
+						   "proc first                     \n"
+						   "{}                             \n"
+						   "    ret                        \n"
+						   "endp first                     \n"
+						   "proc second                    \n"
+						   ".loop:                         \n"
+						   "    draw r0, r1, #s            \n"
+						   "    call $first                \n"
+						   "    jmp @loop                  \n"
+						   "endp second                    \n"
+						   ".main:                         \n"
+						   "    mov r0, N                  \n"
+						   "    call $second               \n"
+						   ".end:                          \n"
+						   "    jmp @end                   \n",
+						   first_proc_body);
+	}
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(incremental_generation, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(unchanged_blocks_are_reused)
+	{
+		chasm::incremental_state state;
+
+		const auto first = details::codegen(details::program("cls"), state);
+		BOOST_CHECK_EQUAL(state.reused_count(), 0);
+
+		const auto second = details::codegen(details::program("cls"), state);
+		BOOST_CHECK_EQUAL(state.encoded_count(), 0);
+		BOOST_CHECK_EQUAL(state.reused_count(), 4);
+
+		BOOST_CHECK_EQUAL_RANGES(first, second);
+	}
+
+	BOOST_AUTO_TEST_CASE(changed_block_moves_references)
+	{
+		chasm::incremental_state state;
+
+		(void) details::codegen(details::program("cls"), state);
+
+		//
+		// "first" grows, every block after it moves and must be re-patched
+		//
+		const auto updated  = details::codegen(details::program("cls\n cls\n mov r3, N"), state);
+		const auto expected = details::codegen(details::program("cls\n cls\n mov r3, N"));
+
+		BOOST_CHECK_EQUAL(state.encoded_count(), 1);
+		BOOST_CHECK_EQUAL(state.reused_count(), 3);
+		BOOST_CHECK_EQUAL_RANGES(updated, expected);
+	}
+
+	BOOST_AUTO_TEST_CASE(environment_change_invalidates)
+	{
+		chasm::incremental_state state;
+
+		(void) details::codegen(details::program("cls"), state);
+
+		auto source = details::program("cls");
+		source.replace(source.find("define N 4"), 10, "define N 5");
+
+		const auto updated  = details::codegen(source, state);
+		const auto expected = details::codegen(source);
+
+		BOOST_CHECK_EQUAL(state.reused_count(), 0);
+		BOOST_CHECK_EQUAL_RANGES(updated, expected);
+	}
+
+	BOOST_AUTO_TEST_CASE(reused_blocks_warn_again)
+	{
+		chasm::incremental_state state;
+
+		const auto cold = details::generation_log(details::program("cls\n scrl\n draw r0, r1, 0"), state);
+
+		BOOST_CHECK(cold.find("scrl at line 5") != std::string::npos);
+		BOOST_CHECK(cold.find("draw at line 6") != std::string::npos);
+
+		//
+		// the blocks are reused from where they moved to, and so are their warnings
+		//
+		const auto warm = details::generation_log("\n" + details::program("cls\n scrl\n draw r0, r1, 0"), state);
+
+		BOOST_CHECK_EQUAL(state.encoded_count(), 0);
+		BOOST_CHECK(warm.find("scrl at line 6") != std::string::npos);
+		BOOST_CHECK(warm.find("draw at line 7") != std::string::npos);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#undef BOOST_CHECK_EQUAL_RANGES
@@ -0,0 +1,152 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/linker.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+
+#include "options_fixture.hpp"
+
+
+#define BOOST_CHECK_EQUAL_RANGES(Rng1, Rng2) BOOST_CHECK_EQUAL_COLLECTIONS(Rng1.begin(), Rng1.end(), Rng2.begin(), Rng2.end())
+
+
+namespace details
+{
+	using namespace chasm;
+
+	ast::abstract_tree parse_program(std::string program)
+	{
+		auto lex = lexer(std::move(program));
+		auto par = parser(lex.enumerate_tokens());
+
+		return par.make_tree();
+	}
+
+	object_file assemble_object(std::string program)
+	{
+		return parse_program(std::move(program)).generate_object();
+	}
+
+	const std::string entry = ".main:               \n"
+							  "    mov r0, 4        \n"
+							  "    call $helper     \n"
+							  ".end:                \n"
+							  "    jmp @end         \n";
+
+	const std::string library = "proc helper          \n"
+								".loop:               \n"
+								"    add r0, 1        \n"
+								"    jmp @loop        \n"
+								"endp helper          \n";
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(object_linking, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(imports_unresolved_procedures)
+	{
+		const auto object = details::assemble_object(details::entry);
+
+		BOOST_REQUIRE_EQUAL(object.imports.size(), 1);
+		BOOST_CHECK_EQUAL(object.imports[0], "helper");
+		BOOST_CHECK_EQUAL(object.relocations.size(), 2);
+		BOOST_CHECK(object.defines_entry_point());
+	}
+
+	BOOST_AUTO_TEST_CASE(serialization_round_trip)
+	{
+		const auto object = details::assemble_object(details::library);
+		const auto copy = chasm::object_file::deserialize(object.serialize());
+
+		BOOST_CHECK_EQUAL_RANGES(object.code, copy.code);
+		BOOST_REQUIRE_EQUAL(copy.exports.size(), 1);
+		BOOST_CHECK_EQUAL(copy.exports[0].name, "helper");
+		BOOST_CHECK_EQUAL(copy.locals.size(), 1);
+		BOOST_CHECK_EQUAL(copy.relocations.size(), 1);
+
+		BOOST_CHECK_THROW((void) chasm::object_file::deserialize(object.code), chasm::chasm_exception);
+	}
+
+	BOOST_AUTO_TEST_CASE(link_matches_single_source)
+	{
+		chasm::linker linker;
+
+		//
+		// the entry object is placed first whatever the order objects are given in
+		//
+		linker.add(details::assemble_object(details::library), "library");
+		linker.add(details::assemble_object(details::entry), "entry");
+
+		const auto linked = linker.link(0x200);
+		const auto expected = details::parse_program(details::library + details::entry).generate();
+
+		BOOST_CHECK_EQUAL_RANGES(linked, expected);
+		BOOST_CHECK_EQUAL(linker.symbols().at("helper"), 6);
+	}
+
+	BOOST_AUTO_TEST_CASE(link_errors)
+	{
+		{
+			chasm::linker linker;
+			linker.add(details::assemble_object(details::library), "library");
+
+			BOOST_CHECK_THROW((void) linker.link(0x200), chasm::chasm_exception);
+		}
+
+		{
+			chasm::linker linker;
+			linker.add(details::assemble_object(details::entry), "entry");
+
+			BOOST_CHECK_THROW((void) linker.link(0x200), chasm::chasm_exception);
+		}
+
+		{
+			chasm::linker linker;
+			linker.add(details::assemble_object(details::entry), "entry");
+			linker.add(details::assemble_object(details::library), "library");
+			linker.add(details::assemble_object(details::library), "copy");
+
+			BOOST_CHECK_THROW((void) linker.link(0x200), chasm::chasm_exception);
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE(sprites_stay_local)
+	{
+		const auto sprite_user = [](std::string_view proc, std::string_view rows)
+		{
+			return std::format("sprite box [{}]     \n"
+							   "proc {}             \n"
+							   "    mov ar, #box    \n"
+							   "    ret             \n"
+							   "endp {}             \n",
+							   rows, proc, proc);
+		};
+
+		const auto object = details::assemble_object(sprite_user("helper", "0xFF"));
+
+		BOOST_REQUIRE_EQUAL(object.exports.size(), 1);
+		BOOST_CHECK_EQUAL(object.exports[0].name, "helper");
+
+		chasm::linker linker;
+		linker.add(details::assemble_object(".main:\n call $first\n call $second\n.end:\n jmp @end\n"), "entry");
+		linker.add(details::assemble_object(sprite_user("first", "0x81")), "first");
+		linker.add(details::assemble_object(sprite_user("second", "0x42")), "second");
+
+		const auto linked = linker.link(0x200);
+
+		//
+		// each procedure points at the sprite of its own object
+		//
+		const auto first_box = linker.symbols().at("first.box");
+		const auto second_box = linker.symbols().at("second.box");
+
+		BOOST_CHECK_NE(first_box, second_box);
+		BOOST_CHECK_EQUAL(linked[first_box], 0x81);
+		BOOST_CHECK_EQUAL(linked[second_box], 0x42);
+
+		const auto first = linker.symbols().at("first");
+		BOOST_CHECK_EQUAL(((linked[first] & 0x0F) << 8 | linked[first + 1]), 0x200 + first_box);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#undef BOOST_CHECK_EQUAL_RANGES
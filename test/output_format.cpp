@@ -0,0 +1,122 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/output_format.hpp>
+#include <chasm/chasm_exception.hpp>
+
+#include <vector>
+
+#include "options_fixture.hpp"
+
+
+namespace details
+{
+	using namespace chasm;
+
+	std::string encoded(output::format fmt, std::string_view bytes, output::encode_parameters params = {})
+	{
+		const std::vector<uint8_t> binary(bytes.begin(), bytes.end());
+		return output::encode(fmt, binary, params);
+	}
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(output_formats, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(format_names)
+	{
+		using chasm::output::format;
+
+		for (const auto fmt : { format::raw, format::ihex, format::c_array, format::base64, format::hexdump })
+			BOOST_CHECK(chasm::output::parse_format(chasm::output::name(fmt)) == fmt);
+
+		BOOST_CHECK(!chasm::output::parse_format("elf"));
+	}
+
+	BOOST_AUTO_TEST_CASE(raw_is_unchanged)
+	{
+		using namespace std::string_view_literals;
+
+		const auto bytes = "\x00\xE0\x12\x00"sv;
+
+		BOOST_CHECK_EQUAL(details::encoded(chasm::output::format::raw, bytes), bytes);
+	}
+
+	BOOST_AUTO_TEST_CASE(base64_padding)
+	{
+		using chasm::output::format;
+
+		BOOST_CHECK_EQUAL(details::encoded(format::base64, ""), "\n");
+		BOOST_CHECK_EQUAL(details::encoded(format::base64, "f"), "Zg==\n");
+		BOOST_CHECK_EQUAL(details::encoded(format::base64, "fo"), "Zm8=\n");
+		BOOST_CHECK_EQUAL(details::encoded(format::base64, "foo"), "Zm9v\n");
+		BOOST_CHECK_EQUAL(details::encoded(format::base64, "foobar"), "Zm9vYmFy\n");
+	}
+
+	BOOST_AUTO_TEST_CASE(ihex_records)
+	{
+		const std::string bytes(20, '\x11');
+
+		BOOST_CHECK_EQUAL(details::encoded(chasm::output::format::ihex, bytes),
+						  ":1002000011111111111111111111111111111111DE\n"
+						  ":0402100011111111A6\n"
+						  ":00000001FF\n");
+
+		// crossing 0x10000 switches to the next extended linear address
+		BOOST_CHECK_EQUAL(details::encoded(chasm::output::format::ihex, bytes, { .base = 0xFFF0 }),
+						  ":10FFF00011111111111111111111111111111111F1\n"
+						  ":020000040001F9\n"
+						  ":0400000011111111B8\n"
+						  ":00000001FF\n");
+	}
+
+	BOOST_AUTO_TEST_CASE(c_array_header)
+	{
+		const auto header = details::encoded(chasm::output::format::c_array, "\x01\xAB", { .array_name = "game" });
+
+		BOOST_CHECK_EQUAL(header,
+						  "#include <stddef.h>\n\n"
+						  "static const unsigned char game[] = {\n"
+						  "\t0x01, 0xAB,\n"
+						  "};\n\n"
+						  "static const size_t game_size = 2;\n");
+	}
+
+	BOOST_AUTO_TEST_CASE(hexdump_lines)
+	{
+		using namespace std::string_view_literals;
+
+		const auto dump = details::encoded(chasm::output::format::hexdump, "\x00\xE0\x12\x00\x0A"sv, { .base = 0x200, .bytes_per_line = 4 });
+
+		BOOST_CHECK_EQUAL(dump,
+						  "0x0200: 00 E0 12 00 \n"
+						  "0x0204: 0A \n");
+	}
+
+	BOOST_AUTO_TEST_CASE(output_files_paths)
+	{
+		const std::vector<std::string> formats { "raw", "ihex", "c" };
+		const auto files = chasm::output::output_files("out.c8c", formats);
+
+		BOOST_REQUIRE_EQUAL(files.size(), 3);
+		BOOST_CHECK(files[0].path == "out.c8c");
+		BOOST_CHECK(files[1].path == "out.hex");
+		BOOST_CHECK(files[2].path == "out.h");
+	}
+
+	BOOST_AUTO_TEST_CASE(output_files_collide)
+	{
+		//
+		// the raw output would overwrite the Intel HEX one written to the output file
+		//
+		const std::vector<std::string> ihex_raw { "ihex", "raw" };
+		const std::vector<std::string> twice { "ihex", "base64", "ihex" };
+		const std::vector<std::string> unknown { "raw", "elf" };
+
+		BOOST_CHECK_THROW((void) chasm::output::output_files("out.c8c", ihex_raw), chasm::chasm_exception);
+		BOOST_CHECK_THROW((void) chasm::output::output_files("out.c8c", twice), chasm::chasm_exception);
+		BOOST_CHECK_THROW((void) chasm::output::output_files("out.c8c", unknown), chasm::chasm_exception);
+		BOOST_CHECK_THROW((void) chasm::output::output_files("-", ihex_raw), chasm::chasm_exception);
+
+		BOOST_CHECK_EQUAL(chasm::output::output_files("out.bin", ihex_raw).size(), 2);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
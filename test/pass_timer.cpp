@@ -0,0 +1,115 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/pass_timer.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+
+#include "options_fixture.hpp"
+
+
+namespace details
+{
+	struct enabled_passes : test_env::default_options
+	{
+		enabled_passes()
+		{
+			chasm::passes::clear();
+			chasm::passes::enable();
+		}
+
+		~enabled_passes()
+		{
+			chasm::passes::enable(false);
+			chasm::passes::clear();
+		}
+	};
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(pass_timing, details::enabled_passes)
+
+	BOOST_AUTO_TEST_CASE(allocations_are_counted)
+	{
+		const auto before = chasm::passes::allocations();
+
+		auto block = std::make_unique<char[]>(1000);
+		block[0] = 1;
+
+		const auto after = chasm::passes::allocations();
+
+		BOOST_CHECK_GE(after.count - before.count, 1);
+		BOOST_CHECK_GE(after.bytes - before.bytes, 1000);
+	}
+
+	BOOST_AUTO_TEST_CASE(nested_passes_in_start_order)
+	{
+		{
+			chasm::passes::scoped_pass outer("outer");
+
+			{
+				chasm::passes::scoped_pass inner("inner");
+				std::vector<int> values(256);
+			}
+		}
+
+		const auto records = chasm::passes::records();
+
+		BOOST_REQUIRE_EQUAL(records.size(), 2);
+
+		BOOST_CHECK_EQUAL(records[0].name, "outer");
+		BOOST_CHECK_EQUAL(records[0].depth, 0);
+		BOOST_CHECK_EQUAL(records[1].name, "inner");
+		BOOST_CHECK_EQUAL(records[1].depth, 1);
+
+		BOOST_CHECK_GE(records[1].allocated_bytes, 256 * sizeof(int));
+		BOOST_CHECK_GE(records[0].allocated_bytes, records[1].allocated_bytes);
+		BOOST_CHECK_GE(records[0].wall_ms, records[1].wall_ms);
+	}
+
+	BOOST_AUTO_TEST_CASE(allocations_counted_while_enabled)
+	{
+		chasm::passes::enable(false);
+
+		const auto before = chasm::passes::allocations();
+		auto block = std::make_unique<char[]>(1000);
+		block[0] = 1;
+
+		BOOST_CHECK_EQUAL(chasm::passes::allocations().count, before.count);
+
+		chasm::passes::enable();
+	}
+
+	BOOST_AUTO_TEST_CASE(pass_names_are_escaped)
+	{
+		{
+			chasm::passes::scoped_pass pass("module \"a\\b\"");
+		}
+
+		BOOST_CHECK(chasm::passes::to_json().contains(R"("name": "module \"a\\b\"")"));
+	}
+
+	BOOST_AUTO_TEST_CASE(generation_passes)
+	{
+		auto lex = chasm::lexer(".main:\n    cls\n    jmp @main\n");
+		auto par = chasm::parser(lex.enumerate_tokens());
+		auto tree = par.make_tree();
+
+		(void) tree.generate();
+
+		const auto json = chasm::passes::to_json();
+
+		for (const auto* name : { "sanitize", "sort", "generate", "patch" })
+			BOOST_CHECK(json.contains(std::format("\"name\": \"{}\"", name)));
+	}
+
+	BOOST_AUTO_TEST_CASE(disabled_passes_are_not_recorded)
+	{
+		chasm::passes::enable(false);
+
+		{
+			chasm::passes::scoped_pass pass("ignored");
+		}
+
+		BOOST_CHECK(chasm::passes::records().empty());
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
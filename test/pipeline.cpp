@@ -0,0 +1,119 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/spsc_queue.hpp>
+#include <chasm/pipeline.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+
+#include <thread>
+
+#include "options_fixture.hpp"
+
+
+#define BOOST_CHECK_EQUAL_RANGES(Rng1, Rng2) BOOST_CHECK_EQUAL_COLLECTIONS(Rng1.begin(), Rng1.end(), Rng2.begin(), Rng2.end())
+
+
+namespace details
+{
+	std::vector<uint8_t> sequential_codegen(std::string program)
+	{
+		auto lex = chasm::lexer(std::move(program));
+		auto par = chasm::parser(lex.enumerate_tokens());
+
+		return par.make_tree().generate();
+	}
+
+	std::string large_program(int procedures)
+	{
+		std::string program = "sprite s [1, 2, 3]\n";
+
+		for (int i = 0; i < procedures; ++i)
+			program += std::format("proc p{0}\n.loop:\n    draw r0, r1, #s\n    call $p{1}\n    jmp @loop\nendp p{0}\n",
+								   i,
+								   (i + 1) % procedures);
+
+		program += ".main:\n    call $p0\n.end:\n    jmp @end\n";
+
+		return program;
+	}
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(pipelined_assembly, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(queue_keeps_order)
+	{
+		chasm::spsc_queue<int, 8> queue;
+		std::vector<int> received;
+
+		std::jthread producer([&queue]
+		{
+			for (int i = 0; i < 1000; ++i)
+				queue.push(int { i });
+
+			queue.close();
+		});
+
+		while (const auto value = queue.pop())
+			received.push_back(*value);
+
+		BOOST_REQUIRE_EQUAL(received.size(), 1000);
+		BOOST_CHECK(std::ranges::is_sorted(received));
+	}
+
+	BOOST_AUTO_TEST_CASE(same_code_as_sequential)
+	{
+		const auto program = details::large_program(300);
+
+		const auto pipelined = chasm::assemble_pipelined(std::string(program));
+		const auto expected = details::sequential_codegen(program);
+
+		BOOST_CHECK_EQUAL_RANGES(pipelined, expected);
+	}
+
+	BOOST_AUTO_TEST_CASE(stage_errors_are_reported)
+	{
+		// lexer
+		BOOST_CHECK_THROW((void) chasm::assemble_pipelined(details::large_program(200) + "\n%"), std::exception);
+
+		// parser
+		BOOST_CHECK_THROW((void) chasm::assemble_pipelined(details::large_program(200) + "\nproc"), std::exception);
+
+		// sanitizer
+		BOOST_CHECK_THROW((void) chasm::assemble_pipelined("proc a\n    call $b\nendp a\n"), std::exception);
+	}
+
+	BOOST_AUTO_TEST_CASE(sanitized_before_generated)
+	{
+		//
+		// the first statement does not encode, but the undefined label after it is reported first
+		//
+		const std::string program = ".main:\n    mov r0, 0x1FF\n.end:\n    jmp @nowhere\n";
+
+		std::string pipelined_error;
+		std::string sequential_error;
+
+		try
+		{
+			(void) chasm::assemble_pipelined(std::string(program));
+		}
+		catch (const std::exception& error)
+		{
+			pipelined_error = error.what();
+		}
+
+		try
+		{
+			(void) details::sequential_codegen(program);
+		}
+		catch (const std::exception& error)
+		{
+			sequential_error = error.what();
+		}
+
+		BOOST_CHECK(sequential_error.contains("nowhere"));
+		BOOST_CHECK_EQUAL(pipelined_error, sequential_error);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#undef BOOST_CHECK_EQUAL_RANGES
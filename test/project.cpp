@@ -0,0 +1,116 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/project.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+
+#include <fstream>
+
+#include "options_fixture.hpp"
+#include "temp_directory.hpp"
+
+
+#define BOOST_CHECK_EQUAL_RANGES(Rng1, Rng2) BOOST_CHECK_EQUAL_COLLECTIONS(Rng1.begin(), Rng1.end(), Rng2.begin(), Rng2.end())
+
+
+namespace details
+{
+	struct project_directory
+	{
+		void write(const std::string& file, const std::string& content) const
+		{
+			std::ofstream(root / file) << content;
+		}
+
+		test_env::temporary_directory directory { "chasm_test_project" };
+		std::filesystem::path root = directory.path;
+	};
+
+	std::vector<std::string> module_names(const chasm::project& project)
+	{
+		std::vector<std::string> names;
+
+		for (const auto& module : project.modules())
+			names.push_back(module.name);
+
+		return names;
+	}
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(project_build, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(modules_sorted_by_dependencies)
+	{
+		const auto project = chasm::project::parse(";; game project              \n"
+												   "output game.c8c              \n"
+												   "module game game.c8 gfx utils \n"
+												   "module gfx gfx.c8 utils      \n"
+												   "\n"
+												   "module utils utils.c8 ;; base\n",
+												   "root");
+
+		const std::vector<std::string> expected = { "utils", "gfx", "game" };
+		const auto names = details::module_names(project);
+
+		BOOST_CHECK_EQUAL_RANGES(names, expected);
+		BOOST_CHECK(project.output() == std::filesystem::path("root") / "game.c8c");
+	}
+
+	BOOST_AUTO_TEST_CASE(invalid_manifests)
+	{
+		BOOST_CHECK_THROW((void) chasm::project::parse("module a a.c8 b\nmodule b b.c8 a\n", "."), chasm::chasm_exception);
+		BOOST_CHECK_THROW((void) chasm::project::parse("module a a.c8 missing\n", "."), chasm::chasm_exception);
+		BOOST_CHECK_THROW((void) chasm::project::parse("module a a.c8\nmodule a b.c8\n", "."), chasm::chasm_exception);
+		BOOST_CHECK_THROW((void) chasm::project::parse("modul a a.c8\n", "."), chasm::chasm_exception);
+		BOOST_CHECK_THROW((void) chasm::project::parse(";; nothing\n", "."), chasm::chasm_exception);
+	}
+
+	BOOST_AUTO_TEST_CASE(rebuilds_changed_modules_only)
+	{
+		const details::project_directory dir;
+
+		const std::string utils = "proc helper    \n"
+								  "    add r0, 1  \n"
+								  "    ret        \n"
+								  "endp helper    \n";
+
+		const std::string game = ".main:         \n"
+								 "    call $helper\n"
+								 ".end:          \n"
+								 "    jmp @end   \n";
+
+		dir.write("utils.c8", utils);
+		dir.write("game.c8", game);
+		dir.write("other.c8", "");
+		dir.write("game.c8p", "module game game.c8 utils\nmodule utils utils.c8\nmodule other other.c8\n");
+
+		const auto project = chasm::project::load(dir.root / "game.c8p");
+		const auto build_dir = dir.root / "build";
+
+		auto lexer = chasm::lexer(utils + game);
+		auto parser = chasm::parser(lexer.enumerate_tokens());
+		const auto expected = parser.make_tree().generate();
+
+		const auto first = project.build(build_dir, 2);
+		BOOST_CHECK_EQUAL_RANGES(first, expected);
+
+		const auto game_time  = std::filesystem::last_write_time(build_dir / "game.c8o");
+		const auto other_time = std::filesystem::last_write_time(build_dir / "other.c8o");
+
+		const auto second = project.build(build_dir, 2);
+		BOOST_CHECK_EQUAL_RANGES(second, expected);
+		BOOST_CHECK(std::filesystem::last_write_time(build_dir / "game.c8o") == game_time);
+
+		//
+		// a dependency change rebuilds its dependents, unrelated modules are kept
+		//
+		dir.write("utils.c8", utils + "\n;; changed\n");
+
+		(void) project.build(build_dir, 2);
+		BOOST_CHECK(std::filesystem::last_write_time(build_dir / "game.c8o") != game_time);
+		BOOST_CHECK(std::filesystem::last_write_time(build_dir / "other.c8o") == other_time);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#undef BOOST_CHECK_EQUAL_RANGES
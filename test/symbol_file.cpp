@@ -0,0 +1,95 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/symbol_file.hpp>
+#include <chasm/generator.hpp>
+#include <chasm/lexer.hpp>
+#include <chasm/parser.hpp>
+
+#include "options_fixture.hpp"
+
+
+namespace details
+{
+	using namespace chasm;
+
+	const symbol_map indexed_symbols = {
+		{ ".main",   0x00 },
+		{ "draw_it", 0x0C },
+		{ ".loop",   0x04 },
+		{ "s",       0x12 },
+		{ "alias",   0x0C }
+	};
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(symbol_files, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(text_sorted_by_address_then_name)
+	{
+		BOOST_CHECK_EQUAL(chasm::format_symbols_text(details::indexed_symbols, 0x200),
+						  "0x0000 0x0200 --> .main\n"
+						  "0x0004 0x0204 --> .loop\n"
+						  "0x000c 0x020c --> alias\n"
+						  "0x000c 0x020c --> draw_it\n"
+						  "0x0012 0x0212 --> s\n");
+	}
+
+	BOOST_AUTO_TEST_CASE(binary_index_lookups)
+	{
+		const std::vector<chasm::source_line> lines = { { 0x00, 12 }, { 0x02, 13 }, { 0x0C, 4 }, { 0x04, 15 } };
+
+		const auto bytes = chasm::make_symbol_index(details::indexed_symbols, lines, 0x200);
+		const auto index = chasm::symbol_index(bytes);
+
+		BOOST_CHECK_EQUAL(index.base(), 0x200);
+		BOOST_REQUIRE_EQUAL(index.symbol_count(), 5);
+		BOOST_CHECK_EQUAL(index.symbol_at(2).name, "alias");
+		BOOST_CHECK_EQUAL(index.symbol_at(2).address, 0x20C);
+
+		// addresses are memory addresses, lookups give the enclosing symbol
+		BOOST_CHECK(!index.find(0x1FF));
+		BOOST_CHECK_EQUAL(index.find(0x200)->name, ".main");
+		BOOST_CHECK_EQUAL(index.find(0x20A)->name, ".loop");
+		BOOST_CHECK_EQUAL(index.find(0x20E)->name, "draw_it");
+		BOOST_CHECK_EQUAL(index.find(0xFFF)->name, "s");
+
+		BOOST_CHECK(!index.line_of(0x100));
+		BOOST_CHECK_EQUAL(*index.line_of(0x201), 12);
+		BOOST_CHECK_EQUAL(*index.line_of(0x206), 15);
+		BOOST_CHECK_EQUAL(*index.line_of(0x20C), 4);
+	}
+
+	BOOST_AUTO_TEST_CASE(binary_index_rejects_bad_files)
+	{
+		auto bytes = chasm::make_symbol_index(details::indexed_symbols, {}, 0x200);
+
+		BOOST_CHECK_THROW(chasm::symbol_index(std::span(bytes).first(bytes.size() - 1)), chasm::chasm_exception);
+
+		bytes[0] = 'X';
+		BOOST_CHECK_THROW(chasm::symbol_index { bytes }, chasm::chasm_exception);
+	}
+
+	BOOST_AUTO_TEST_CASE(generator_records_source_lines)
+	{
+		auto lex = chasm::lexer(".main:          \n"
+								"    cls         \n"
+								"    swp r1, r2  \n"
+								"    raw(0x00EE) \n");
+		auto par = chasm::parser(lex.enumerate_tokens());
+		auto tree = par.make_tree();
+
+		chasm::generator generator;
+		(void) generator.generate(tree);
+
+		const auto& lines = generator.source_lines();
+
+		// swp expands to three opcodes
+		BOOST_REQUIRE_EQUAL(lines.size(), 3);
+		BOOST_CHECK_EQUAL(lines[0].offset, 0);
+		BOOST_CHECK_EQUAL(lines[0].line, 2);
+		BOOST_CHECK_EQUAL(lines[1].offset, 2);
+		BOOST_CHECK_EQUAL(lines[1].line, 3);
+		BOOST_CHECK_EQUAL(lines[2].offset, 8);
+		BOOST_CHECK_EQUAL(lines[2].line, 4);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,49 @@
+#ifndef CHASM_TEMP_DIRECTORY_HPP
+#define CHASM_TEMP_DIRECTORY_HPP
+
+#include <filesystem>
+#include <format>
+#include <random>
+#include <string_view>
+
+
+namespace test_env
+{
+	/// scratch directory created under the system temporary directory and removed with everything in it
+	/// once the test is done
+
+	//
+	// The name gets a random suffix so that test runs started at the same time do not remove each
+	// other's files. create_directory fails on an existing directory, a new suffix is then drawn.
+	//
+	struct temporary_directory
+	{
+		explicit temporary_directory(std::string_view prefix = "chasm_test")
+		{
+			std::random_device rd;
+
+			do
+			{
+				const auto nonce = (static_cast<uint64_t>(rd()) << 32) | rd();
+				path = std::filesystem::temp_directory_path() / std::format("{}_{:016x}", prefix, nonce);
+			}
+			while (!std::filesystem::create_directory(path));
+		}
+
+		temporary_directory(const temporary_directory&) = delete;
+		temporary_directory(temporary_directory&&) noexcept = delete;
+		temporary_directory& operator=(const temporary_directory&) = delete;
+		temporary_directory& operator=(temporary_directory&&) noexcept = delete;
+
+		~temporary_directory()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(path, ec);
+		}
+
+		std::filesystem::path path;
+	};
+}
+
+
+#endif //CHASM_TEMP_DIRECTORY_HPP
@@ -0,0 +1,117 @@
+#include <boost/test/unit_test.hpp>
+#include <chasm/spsc_queue.hpp>
+#include <chasm/trace.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "options_fixture.hpp"
+#include "temp_directory.hpp"
+
+
+namespace details
+{
+	std::string traced_events()
+	{
+		const test_env::temporary_directory directory("chasm_test_trace");
+		const auto path = directory.path / "trace.json";
+
+		chasm::trace::write(path);
+
+		std::ifstream is(path, std::ios::binary);
+
+		return { std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+	}
+}
+
+
+BOOST_FIXTURE_TEST_SUITE(trace_events, test_env::default_options)
+
+	BOOST_AUTO_TEST_CASE(spans_of_every_thread)
+	{
+		chasm::trace::enable();
+
+		{
+			chasm::trace::scoped_span span("traced main", "test", "main \"file\".c8");
+			chasm::trace::instant("traced marker", "cache");
+
+			std::jthread worker([]
+			{
+				chasm::trace::set_thread_name("traced worker");
+				chasm::trace::scoped_span span("traced work", "test");
+			});
+		}
+
+		chasm::trace::enable(false);
+
+		{
+			chasm::trace::scoped_span span("untraced", "test");
+		}
+
+		const auto json = details::traced_events();
+
+		BOOST_CHECK(json.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+		BOOST_CHECK(json.contains(R"("ph":"X")"));
+		BOOST_CHECK(json.contains(R"("name":"traced main","cat":"test")"));
+		BOOST_CHECK(json.contains(R"("args":{"detail":"main \"file\".c8"})"));
+		BOOST_CHECK(json.contains(R"("ph":"i")"));
+		BOOST_CHECK(json.contains(R"("args":{"name":"traced worker"})"));
+		BOOST_CHECK(json.contains(R"("name":"traced work")"));
+		BOOST_CHECK(!json.contains("untraced"));
+	}
+
+	BOOST_AUTO_TEST_CASE(events_written_once)
+	{
+		chasm::trace::enable();
+
+		std::jthread([]
+		{
+			chasm::trace::set_thread_name("first build");
+			chasm::trace::instant("first event", "test");
+		}).join();
+
+		chasm::trace::enable(false);
+
+		BOOST_CHECK(details::traced_events().contains("first event"));
+
+		chasm::trace::enable();
+		chasm::trace::instant("second event", "test");
+		chasm::trace::enable(false);
+
+		//
+		// the thread of the first write is done, so its name is not repeated either
+		//
+		const auto json = details::traced_events();
+
+		BOOST_CHECK(json.contains("second event"));
+		BOOST_CHECK(!json.contains("first event"));
+		BOOST_CHECK(!json.contains("first build"));
+	}
+
+	BOOST_AUTO_TEST_CASE(queue_waits_are_spans)
+	{
+		chasm::trace::enable();
+
+		chasm::spsc_queue<int, 2> queue;
+
+		std::jthread consumer([&queue]
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+			while (queue.pop())
+				;
+		});
+
+		for (int i = 0; i < 16; ++i)
+			queue.push(int { i });
+
+		queue.close();
+		consumer.join();
+
+		chasm::trace::enable(false);
+
+		BOOST_CHECK(details::traced_events().contains(R"("name":"queue full","cat":"queue")"));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()